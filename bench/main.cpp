@@ -0,0 +1,701 @@
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../src/EulerAngle.h"
+#include "../src/Quaternion.h"
+#include "../src/RotationMatrix.h"
+#include "../src/Vector3.h"
+#include "../src/conversion.h"
+#include "../src/batchConversion.h"
+#include "../src/batchRotation.h"
+#include "../src/parallelConversion.h"
+#include "../src/executionConversion.h"
+#include "../src/QuaternionCodec.h"
+#include "../src/spanConversion.h"
+#include "../src/SinCosTable.h"
+#include "../src/EulerAngleCache.h"
+#include "../src/batchInterpolation.h"
+#include "../src/trackResampling.h"
+#include "../src/hierarchy.h"
+#include "../src/orthonormalization.h"
+#include "../src/quaternionNormalization.h"
+
+const float PI = 3.14159265359f;
+const float HALF_PI = 0.5f * PI;
+
+const EulerOrder EULER_ORDERS[] = {
+  EulerOrder::XYZ, EulerOrder::XZY, EulerOrder::YXZ, EulerOrder::YZX, EulerOrder::ZXY, EulerOrder::ZYX
+};
+
+// Middle angle of the order is pinned to +-PI/2 for gimbal-locked inputs.
+std::vector<EulerAngle> makeEulerAngles(size_t count, EulerOrder order, bool locked) {
+  std::vector<EulerAngle> angles;
+  angles.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    auto a = std::fmod(0.37f * i, 2 * PI) - PI;
+    auto b = std::fmod(0.11f * i, PI) - HALF_PI;
+    auto c = std::fmod(0.23f * i, 2 * PI) - PI;
+    if (locked) {
+      b = i % 2 == 0 ? HALF_PI : -HALF_PI;
+    }
+    switch (order) {
+    case EulerOrder::XYZ:
+    case EulerOrder::ZYX:
+      angles.push_back(EulerAngle(a, b, c, order));
+      break;
+    case EulerOrder::XZY:
+    case EulerOrder::YZX:
+      angles.push_back(EulerAngle(a, c, b, order));
+      break;
+    case EulerOrder::YXZ:
+    case EulerOrder::ZXY:
+      angles.push_back(EulerAngle(b, a, c, order));
+      break;
+    }
+  }
+  return angles;
+}
+
+std::vector<Quaternion> makeQuaternions(size_t count, EulerOrder order, bool locked) {
+  std::vector<Quaternion> quaternions;
+  quaternions.reserve(count);
+  for (auto e : makeEulerAngles(count, order, locked)) {
+    quaternions.push_back(toQuaternion(e));
+  }
+  return quaternions;
+}
+
+std::vector<RotationMatrix> makeRotationMatrices(size_t count, EulerOrder order, bool locked) {
+  std::vector<RotationMatrix> matrices;
+  matrices.reserve(count);
+  for (auto e : makeEulerAngles(count, order, locked)) {
+    matrices.push_back(toRotationMatrix(e));
+  }
+  return matrices;
+}
+
+void setCounters(benchmark::State& state, size_t count) {
+  state.SetItemsProcessed(state.iterations() * count);
+  // Seconds per element, printed with its unit, e.g. 12.3ns.
+  state.counters["time/op"] = benchmark::Counter(static_cast<double>(count),
+    benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+void BM_QuaternionToEulerAngle(benchmark::State& state) {
+  auto order = EULER_ORDERS[state.range(0)];
+  auto count = static_cast<size_t>(state.range(1));
+  auto quaternions = makeQuaternions(count, order, state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto q : quaternions) {
+      benchmark::DoNotOptimize(toEulerAngle(q, order));
+    }
+  }
+  setCounters(state, count);
+}
+
+// A stream where 70% of the quaternions repeat one of the last 1000, converted with (range(1) = 1) or without the
+// thread-local cache.
+void BM_QuaternionToEulerAngleCached(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto distinct = makeQuaternions(count, EulerOrder::XYZ, false);
+  std::vector<Quaternion> quaternions;
+  uint32_t random = 12345;
+  for (size_t i = 0; i < count; i++) {
+    random = random * 1664525 + 1013904223;
+    auto repeat = i > 0 && random % 10 < 7;
+    quaternions.push_back(repeat ? quaternions[i - 1 - (random >> 16) % std::min<size_t>(i, 1000)] : distinct[i]);
+  }
+  auto cached = state.range(1) != 0;
+  for (auto _ : state) {
+    for (const auto& q : quaternions) {
+      benchmark::DoNotOptimize(cached ? toEulerAngleCached(q, EulerOrder::ZYX) : toEulerAngle(q, EulerOrder::ZYX));
+    }
+  }
+  setCounters(state, count);
+  auto& cache = threadEulerAngleCache<float>();
+  state.counters["hit_rate"] = cache.hits() + cache.misses() == 0 ? 0.0 :
+    static_cast<double>(cache.hits()) / (cache.hits() + cache.misses());
+  cache.resetCounters();
+}
+
+void BM_RotationMatrixToEulerAngle(benchmark::State& state) {
+  auto order = EULER_ORDERS[state.range(0)];
+  auto count = static_cast<size_t>(state.range(1));
+  auto matrices = makeRotationMatrices(count, order, state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto m : matrices) {
+      benchmark::DoNotOptimize(toEulerAngle(m, order));
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_EulerAngleToQuaternion(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  auto angles = makeEulerAngles(count, EULER_ORDERS[state.range(0)], state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto e : angles) {
+      benchmark::DoNotOptimize(toQuaternion(e));
+    }
+  }
+  setCounters(state, count);
+}
+
+// Double angles on a 0.01 degree grid, converted with exact trig (budget 0) or with a table of range(3) bytes.
+void BM_EulerAngleToQuaternionTable(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  std::vector<EulerAngled> angles;
+  for (auto e : makeEulerAngles(count, EULER_ORDERS[state.range(0)], state.range(2) != 0)) {
+    auto step = [](double angle) { return std::round(angle * 18000 / constexprMath::PI) * constexprMath::PI / 18000; };
+    angles.push_back(EulerAngled(step(e.x), step(e.y), step(e.z), e.order));
+  }
+  if (state.range(3) == 0) {
+    for (auto _ : state) {
+      for (auto e : angles) {
+        benchmark::DoNotOptimize(toQuaternion(e));
+      }
+    }
+  } else {
+    SinCosTabled table(36000, static_cast<size_t>(state.range(3)));
+    for (auto _ : state) {
+      for (auto e : angles) {
+        benchmark::DoNotOptimize(toQuaternion(e, table));
+      }
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_EulerAngleToRotationMatrix(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  auto angles = makeEulerAngles(count, EULER_ORDERS[state.range(0)], state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto e : angles) {
+      benchmark::DoNotOptimize(toRotationMatrix(e));
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixToQuaternion(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  auto matrices = makeRotationMatrices(count, EULER_ORDERS[state.range(0)], state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto m : matrices) {
+      benchmark::DoNotOptimize(toQuaternion(m));
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionToRotationMatrix(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  auto quaternions = makeQuaternions(count, EULER_ORDERS[state.range(0)], state.range(2) != 0);
+  for (auto _ : state) {
+    for (auto q : quaternions) {
+      benchmark::DoNotOptimize(toRotationMatrix(q));
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionRotate(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto quaternions = makeQuaternions(count, EulerOrder::XYZ, false);
+  auto v = Vector3(2, 3, 5);
+  for (auto _ : state) {
+    for (auto q : quaternions) {
+      benchmark::DoNotOptimize(q.rotate(v));
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixMultiplyVector3(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto matrices = makeRotationMatrices(count, EulerOrder::XYZ, false);
+  auto v = Vector3(2, 3, 5);
+  for (auto _ : state) {
+    for (auto m : matrices) {
+      benchmark::DoNotOptimize(m * v);
+    }
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionToEulerAngleBatch(benchmark::State& state) {
+  auto order = EULER_ORDERS[state.range(0)];
+  auto count = static_cast<size_t>(state.range(1));
+  std::vector<float> x, y, z, w, ex(count), ey(count), ez(count);
+  for (auto q : makeQuaternions(count, order, state.range(2) != 0)) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  for (auto _ : state) {
+    toEulerAngleBatch(x.data(), y.data(), z.data(), w.data(), count, order, ex.data(), ey.data(), ez.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixToQuaternionBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  std::vector<float> elements, x(count), y(count), z(count), w(count);
+  for (auto m : makeRotationMatrices(count, EULER_ORDERS[state.range(0)], state.range(2) != 0)) {
+    elements.insert(elements.end(), m.elements.begin(), m.elements.end());
+  }
+  for (auto _ : state) {
+    toQuaternionBatch(elements.data(), count, x.data(), y.data(), z.data(), w.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_EulerAngleToRotationMatrixBatch(benchmark::State& state) {
+  auto order = EULER_ORDERS[state.range(0)];
+  auto count = static_cast<size_t>(state.range(1));
+  std::vector<float> x, y, z, elements(9 * count);
+  for (auto e : makeEulerAngles(count, order, state.range(2) != 0)) {
+    x.push_back(e.x);
+    y.push_back(e.y);
+    z.push_back(e.z);
+  }
+  for (auto _ : state) {
+    toRotationMatrixBatch(x.data(), y.data(), z.data(), count, order, elements.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionRotateBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  std::vector<float> x, y, z, w, vx(count, 2), vy(count, 3), vz(count, 5), rx(count), ry(count), rz(count);
+  for (auto q : makeQuaternions(count, EulerOrder::XYZ, false)) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  for (auto _ : state) {
+    rotateBatch(x.data(), y.data(), z.data(), w.data(), vx.data(), vy.data(), vz.data(), count, rx.data(), ry.data(), rz.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixRotateBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto m = toRotationMatrix(EulerAngle(0.3f, -1.2f, 2.5f, EulerOrder::XYZ));
+  std::vector<float> x(count, 2), y(count, 3), z(count, 5);
+  for (auto _ : state) {
+    rotateBatch(m, x.data(), y.data(), z.data(), count, x.data(), y.data(), z.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixRotateInterleavedBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto m = toRotationMatrix(EulerAngle(0.3f, -1.2f, 2.5f, EulerOrder::XYZ));
+  std::vector<float> xyz(3 * count, 2);
+  for (auto _ : state) {
+    rotateInterleavedBatch(m, xyz.data(), count, xyz.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_ParallelQuaternionToEulerAngle(benchmark::State& state) {
+  ThreadPool pool(state.range(0));
+  auto count = static_cast<size_t>(state.range(1));
+  auto quaternions = makeQuaternions(count, EulerOrder::ZXY, false);
+  std::vector<EulerAngle> angles(count, EulerAngle(0, 0, 0, EulerOrder::ZXY));
+  for (auto _ : state) {
+    toEulerAngle(pool, quaternions.data(), count, EulerOrder::ZXY, angles.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_ParallelQuaternionToEulerAngleBatch(benchmark::State& state) {
+  ThreadPool pool(state.range(0));
+  auto count = static_cast<size_t>(state.range(1));
+  std::vector<float> x, y, z, w, ex(count), ey(count), ez(count);
+  for (auto q : makeQuaternions(count, EulerOrder::ZXY, false)) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  for (auto _ : state) {
+    toEulerAngleBatch(pool, x.data(), y.data(), z.data(), w.data(), count, EulerOrder::ZXY, ex.data(), ey.data(), ez.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// Filling an output array with the by-value conversions, for comparison with the span overloads below.
+void BM_RotationMatrixToEulerAngleByValue(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto matrices = makeRotationMatrices(count, EulerOrder::ZXY, false);
+  std::vector<EulerAngle> angles(count, EulerAngle(0, 0, 0, EulerOrder::ZXY));
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      angles[i] = toEulerAngle(matrices[i], EulerOrder::ZXY);
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixToEulerAngleSpan(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto matrices = makeRotationMatrices(count, EulerOrder::ZXY, false);
+  std::vector<EulerAngle> angles(count, EulerAngle(0, 0, 0, EulerOrder::ZXY));
+  for (auto _ : state) {
+    toEulerAngle(matrices, EulerOrder::ZXY, angles);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixToQuaternionByValue(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto matrices = makeRotationMatrices(count, EulerOrder::ZXY, false);
+  std::vector<Quaternion> quaternions(count, Quaternion(0, 0, 0, 1));
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; i++) {
+      quaternions[i] = toQuaternion(matrices[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_RotationMatrixToQuaternionSpan(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto matrices = makeRotationMatrices(count, EulerOrder::ZXY, false);
+  std::vector<Quaternion> quaternions(count, Quaternion(0, 0, 0, 1));
+  for (auto _ : state) {
+    toQuaternion(matrices, quaternions);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// Bone tracks of 30 keys each sampled at one time: range(1) selects the scalar loop of slerp and toRotationMatrix
+// (0), sampleTracks to quaternions (1) or sampleTracks to rotation matrices (2).
+void BM_SampleTracks(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  const size_t keyCount = 30;
+  std::vector<float> times;
+  for (size_t k = 0; k < keyCount; k++) {
+    times.push_back(static_cast<float>(k) / 30);
+  }
+  auto keys = makeQuaternions(count * keyCount, EulerOrder::XYZ, false);
+  std::vector<QuaternionTrack> tracks;
+  for (size_t i = 0; i < count; i++) {
+    tracks.push_back(QuaternionTrack{ times.data(), keys.data() + i * keyCount, keyCount });
+  }
+  std::vector<float> x(count), y(count), z(count), w(count);
+  std::vector<RotationMatrix> matrices(count, RotationMatrix::rotationX(0));
+  auto time = 0.51f;
+  for (auto _ : state) {
+    switch (state.range(1)) {
+    case 0:
+      for (size_t i = 0; i < count; i++) {
+        const auto& track = tracks[i];
+        auto next = static_cast<size_t>(std::upper_bound(track.times, track.times + keyCount, time) - track.times);
+        auto t = (time - track.times[next - 1]) / (track.times[next] - track.times[next - 1]);
+        matrices[i] = toRotationMatrix(slerp(track.keys[next - 1], track.keys[next], t));
+      }
+      break;
+    case 1:
+      sampleTracks(tracks.data(), count, time, Interpolation::Slerp, x.data(), y.data(), z.data(), w.data());
+      break;
+    default:
+      sampleTracks(tracks.data(), count, time, Interpolation::Slerp, matrices.data());
+      break;
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// 1000 euler tracks of 20 keys over 10 seconds resampled to 60 frames per second.
+void BM_ResampleTracks(benchmark::State& state) {
+  const size_t trackCount = 1000, keyCount = 20;
+  auto angles = makeEulerAngles(trackCount * keyCount, EulerOrder::ZXY, false);
+  std::vector<float> times;
+  for (size_t k = 0; k < keyCount; k++) {
+    times.push_back(10.0f * k / (keyCount - 1));
+  }
+  std::vector<EulerAngleTrack> tracks;
+  for (size_t i = 0; i < trackCount; i++) {
+    tracks.push_back(EulerAngleTrack{ times.data(), angles.data() + i * keyCount, keyCount });
+  }
+  auto offsets = resampledTrackOffsets(tracks.data(), trackCount, 60);
+  std::vector<Quaternion> frames(offsets.back(), Quaternion(0, 0, 0, 1));
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    resampleTracks(pool, tracks.data(), trackCount, 60, Interpolation::Slerp, offsets.data(), frames.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, offsets.back());
+}
+
+// Parents of a skeleton of count joints: mostly chains, with a branch every 7 joints.
+std::vector<int32_t> makeParents(size_t count) {
+  std::vector<int32_t> parents(count, NO_PARENT);
+  for (size_t j = 1; j < count; j++) {
+    parents[j] = static_cast<int32_t>(j % 7 == 0 ? (j * 2654435761u) % j : j - 1);
+  }
+  return parents;
+}
+
+void BM_ComposeHierarchyChained(benchmark::State& state) {
+  const size_t count = 500;
+  auto parents = makeParents(count);
+  auto local = makeRotationMatrices(count, EulerOrder::XYZ, false);
+  std::vector<RotationMatrix> world(count, local[0]);
+  for (auto _ : state) {
+    for (size_t j = 0; j < count; j++) {
+      auto m = local[j];
+      for (auto parent = parents[j]; parent != NO_PARENT; parent = parents[parent]) {
+        m = local[parent] * m;
+      }
+      world[j] = m;
+    }
+    benchmark::DoNotOptimize(world.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// The same 500 joint skeleton, composed in one sweep.
+template <class R>
+void BM_ComposeHierarchy(benchmark::State& state) {
+  const size_t count = 500;
+  auto parents = makeParents(count);
+  std::vector<R> local;
+  for (auto q : makeQuaternions(count, EulerOrder::XYZ, false)) {
+    if constexpr (std::is_same_v<R, Quaternion>) {
+      local.push_back(q);
+    } else {
+      local.push_back(toRotationMatrix(q));
+    }
+  }
+  std::vector<R> world(count, local[0]);
+  for (auto _ : state) {
+    composeHierarchy(local.data(), parents.data(), count, world.data());
+    benchmark::DoNotOptimize(world.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// 1024 instances of the skeleton, joint-major SoA.
+void BM_ComposeHierarchyBatch(benchmark::State& state) {
+  const size_t jointCount = 500, instanceCount = 1024;
+  auto parents = makeParents(jointCount);
+  auto local = makeQuaternions(jointCount * instanceCount, EulerOrder::XYZ, false);
+  std::vector<float> lx, ly, lz, lw;
+  for (auto q : local) {
+    lx.push_back(q.x);
+    ly.push_back(q.y);
+    lz.push_back(q.z);
+    lw.push_back(q.w);
+  }
+  std::vector<float> wx(lx.size()), wy(lx.size()), wz(lx.size()), ww(lx.size());
+  ThreadPool pool(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    composeHierarchyBatch(pool, parents.data(), jointCount, instanceCount, lx.data(), ly.data(), lz.data(), lw.data(),
+      wx.data(), wy.data(), wz.data(), ww.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, jointCount * instanceCount);
+}
+
+// Rotation matrices with a drift of about 1e-3, orthonormalized one by one (output 0) or in a batch (output 1).
+void BM_Orthonormalize(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto mode = state.range(1) == 0 ? Orthonormalization::GramSchmidt : Orthonormalization::Polar;
+  auto matrices = makeRotationMatrices(count, EulerOrder::XYZ, false);
+  for (size_t i = 0; i < count; i++) {
+    for (size_t k = 0; k < 9; k++) {
+      matrices[i][k] += 1e-3f * std::sin(static_cast<float>(i + k));
+    }
+  }
+  auto result = matrices;
+  std::vector<float> drift(count);
+  for (auto _ : state) {
+    if (state.range(2) == 0) {
+      for (size_t i = 0; i < count; i++) {
+        drift[i] = orthonormalityDrift(matrices[i]);
+        result[i] = orthonormalize(matrices[i], mode);
+      }
+    } else {
+      orthonormalizeBatch(mode, matrices.data(), count, result.data(), drift.data());
+    }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// Normalizes and canonicalizes scaled quaternions with normalize and canonicalize (batch 0), or normalizeBatch on
+// packed quaternions (1) or on separate component arrays (2).
+void BM_QuaternionNormalize(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  auto quaternions = makeQuaternions(count, EulerOrder::XYZ, false);
+  for (size_t i = 0; i < count; i++) {
+    auto scale = 1 + 1e-3f * std::sin(static_cast<float>(i));
+    auto& q = quaternions[i];
+    q = Quaternion(scale * q.x, scale * q.y, scale * q.z, scale * q.w);
+  }
+  auto result = quaternions;
+  std::vector<float> x, y, z, w;
+  for (auto q : quaternions) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  std::vector<float> rx(count), ry(count), rz(count), rw(count);
+  for (auto _ : state) {
+    if (state.range(1) == 0) {
+      for (size_t i = 0; i < count; i++) {
+        result[i] = canonicalize(normalize(quaternions[i]));
+      }
+    } else if (state.range(1) == 1) {
+      normalizeBatch(quaternions.data(), count, result.data());
+    } else {
+      normalizeBatch(x.data(), y.data(), z.data(), w.data(), count, rx.data(), ry.data(), rz.data(), rw.data());
+    }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionEncodeBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  std::vector<float> x, y, z, w;
+  for (auto q : makeQuaternions(count, EulerOrder::XYZ, false)) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  std::vector<PackedQuaternion32> packed(count);
+  for (auto _ : state) {
+    encodeQuaternionBatch(x.data(), y.data(), z.data(), w.data(), count, packed.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+void BM_QuaternionDecodeBatch(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(0));
+  std::vector<PackedQuaternion32> packed;
+  for (auto q : makeQuaternions(count, EulerOrder::XYZ, false)) {
+    packed.push_back(encodeQuaternion32(q));
+  }
+  std::vector<float> x(count), y(count), z(count), w(count);
+  for (auto _ : state) {
+    decodeQuaternionBatch(packed.data(), count, x.data(), y.data(), z.data(), w.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// First argument selects seq, par or par_unseq.
+void BM_ExecutionQuaternionToEulerAngle(benchmark::State& state) {
+  auto count = static_cast<size_t>(state.range(1));
+  auto quaternions = makeQuaternions(count, EulerOrder::ZXY, false);
+  std::vector<EulerAngle> angles(count, EulerAngle(0, 0, 0, EulerOrder::ZXY));
+  for (auto _ : state) {
+    switch (state.range(0)) {
+    case 0:
+      toEulerAngle(std::execution::seq, quaternions.begin(), quaternions.end(), EulerOrder::ZXY, angles.begin());
+      break;
+    case 1:
+      toEulerAngle(std::execution::par, quaternions.begin(), quaternions.end(), EulerOrder::ZXY, angles.begin());
+      break;
+    default:
+      toEulerAngle(std::execution::par_unseq, quaternions.begin(), quaternions.end(), EulerOrder::ZXY, angles.begin());
+      break;
+    }
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, count);
+}
+
+// Arguments are order index, batch size and whether inputs are gimbal-locked.
+void orderArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({ "order", "count", "locked" });
+  b->ArgsProduct({ benchmark::CreateDenseRange(0, 5, 1), benchmark::CreateRange(1, 1 << 20, 32), { 0, 1 } });
+}
+
+void sizeArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({ "count" });
+  b->RangeMultiplier(32)->Range(1, 1 << 20);
+}
+
+// Thread counts from 1 up to the hardware concurrency, doubling, on batches large enough to amortize the dispatch.
+void threadArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({ "threads", "count" });
+  auto hardware = std::max<int64_t>(std::thread::hardware_concurrency(), 1);
+  for (int64_t threads = 1; threads < 2 * hardware; threads *= 2) {
+    for (auto count : { 1 << 16, 1 << 22 }) {
+      b->Args({ threads < hardware ? threads : hardware, count });
+    }
+  }
+  b->UseRealTime();
+}
+
+BENCHMARK(BM_QuaternionToEulerAngle)->Apply(orderArguments);
+BENCHMARK(BM_QuaternionToEulerAngleCached)->ArgNames({ "count", "cached" })->ArgsProduct({ { 1 << 16 }, { 0, 1 } });
+BENCHMARK(BM_RotationMatrixToEulerAngle)->Apply(orderArguments);
+BENCHMARK(BM_EulerAngleToQuaternion)->Apply(orderArguments);
+BENCHMARK(BM_EulerAngleToQuaternionTable)->ArgNames({ "order", "count", "locked", "budget" })
+  ->ArgsProduct({ { 0 }, { 1 << 10, 1 << 20 }, { 0 }, { 0, 1 << 18, 1 << 21 } });
+BENCHMARK(BM_EulerAngleToRotationMatrix)->Apply(orderArguments);
+BENCHMARK(BM_RotationMatrixToQuaternion)->Apply(orderArguments);
+BENCHMARK(BM_QuaternionToRotationMatrix)->Apply(orderArguments);
+BENCHMARK(BM_QuaternionRotate)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixMultiplyVector3)->Apply(sizeArguments);
+BENCHMARK(BM_QuaternionToEulerAngleBatch)->Apply(orderArguments);
+BENCHMARK(BM_RotationMatrixToQuaternionBatch)->Apply(orderArguments);
+BENCHMARK(BM_EulerAngleToRotationMatrixBatch)->Apply(orderArguments);
+BENCHMARK(BM_QuaternionRotateBatch)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixRotateBatch)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixRotateInterleavedBatch)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixToEulerAngleByValue)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixToEulerAngleSpan)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixToQuaternionByValue)->Apply(sizeArguments);
+BENCHMARK(BM_RotationMatrixToQuaternionSpan)->Apply(sizeArguments);
+BENCHMARK(BM_SampleTracks)->ArgNames({ "count", "output" })->ArgsProduct({ { 1 << 10, 1 << 14 }, { 0, 1, 2 } });
+BENCHMARK(BM_ResampleTracks)->ArgNames({ "threads" })->DenseRange(1, 4, 1)->UseRealTime();
+BENCHMARK(BM_ComposeHierarchyChained);
+BENCHMARK_TEMPLATE(BM_ComposeHierarchy, RotationMatrix);
+BENCHMARK_TEMPLATE(BM_ComposeHierarchy, Quaternion);
+BENCHMARK(BM_ComposeHierarchyBatch)->ArgNames({ "threads" })->DenseRange(1, 4, 1)->UseRealTime();
+BENCHMARK(BM_Orthonormalize)->ArgNames({ "count", "polar", "batch" })->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 }, { 0, 1 } });
+BENCHMARK(BM_QuaternionNormalize)->ArgNames({ "count", "batch" })->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1, 2 } });
+BENCHMARK(BM_QuaternionEncodeBatch)->Apply(sizeArguments);
+BENCHMARK(BM_QuaternionDecodeBatch)->Apply(sizeArguments);
+BENCHMARK(BM_ParallelQuaternionToEulerAngle)->Apply(threadArguments);
+BENCHMARK(BM_ParallelQuaternionToEulerAngleBatch)->Apply(threadArguments);
+BENCHMARK(BM_ExecutionQuaternionToEulerAngle)->ArgNames({ "policy", "count" })->ArgsProduct({ { 0, 1, 2 }, { 1 << 16, 1 << 22 } })
+  ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,393 @@
+#ifndef __CONVERT_H__
+#define __CONVERT_H__
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../src/EulerAngle.h"
+#include "../src/Quaternion.h"
+#include "../src/RotationMatrix.h"
+#include "../src/ThreadPool.h"
+#include "../src/conversion.h"
+#include "../src/rotationFileConversion.h"
+
+// Streams rotations from stdin to stdout, one record per line:
+//   euler       x, y, z (radians)
+//   quaternion  x, y, z, w
+//   matrix      9 elements in RotationMatrix::elements order
+// Numbers may be separated by anything that is not part of a number, so CSV rows and JSON arrays written one record
+// per line both work. Lines without numbers (headers, brackets, blank lines) are skipped. Output is CSV with the
+// shortest representation that parses back to the same value.
+//
+// With --input and --output, binary rotation files (RotationFile.h) are converted instead: the input is mapped, the
+// records are converted in parallel shards and written through a pre-sized mapping of the output. The input
+// representation and precision come from the file header.
+
+const char* USAGE =
+  "usage: convert --from euler|quaternion|matrix --to euler|quaternion|matrix [options] < input > output\n"
+  "       convert --to euler|quaternion|matrix --input FILE --output FILE [options]\n"
+  "  --order XYZ|XZY|YXZ|YZX|ZXY|ZYX  euler order of input and output (default XYZ)\n"
+  "  --from-order ORDER               euler order of the input\n"
+  "  --to-order ORDER                 euler order of the output\n"
+  "  --double                         convert in double instead of float precision\n"
+  "  --threads N                      number of threads (default: hardware concurrency)\n"
+  "  --input FILE, --output FILE      convert binary rotation files\n";
+
+// Input is read in blocks of this size and each block is split into pieces that are converted in parallel.
+const size_t BLOCK_SIZE = 16 << 20;
+const size_t PIECES_PER_THREAD = 4;
+
+enum class Representation {
+  Euler,
+  Quaternion,
+  Matrix
+};
+
+class Options {
+public:
+  Representation from = Representation::Euler;
+  Representation to = Representation::Quaternion;
+  EulerOrder fromOrder = EulerOrder::XYZ;
+  EulerOrder toOrder = EulerOrder::XYZ;
+  bool doublePrecision = false;
+  size_t threads = std::thread::hardware_concurrency();
+  const char* input = nullptr;
+  const char* output = nullptr;
+};
+
+class ParseError {
+public:
+  const char* at = nullptr;
+  const char* message = nullptr;
+};
+
+size_t components(Representation representation) {
+  switch (representation) {
+  case Representation::Euler:
+    return 3;
+  case Representation::Quaternion:
+    return 4;
+  default:
+    return 9;
+  }
+}
+
+bool parseRepresentation(const char* text, Representation& representation) {
+  if (std::strcmp(text, "euler") == 0) {
+    representation = Representation::Euler;
+  } else if (std::strcmp(text, "quaternion") == 0) {
+    representation = Representation::Quaternion;
+  } else if (std::strcmp(text, "matrix") == 0) {
+    representation = Representation::Matrix;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool parseOrder(const char* text, EulerOrder& order) {
+  const char* names[] = { "XYZ", "XZY", "YXZ", "YZX", "ZXY", "ZYX" };
+  for (size_t i = 0; i < 6; i++) {
+    if (std::strcmp(text, names[i]) == 0) {
+      order = static_cast<EulerOrder>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string flag = argv[i];
+    if (flag == "--double") {
+      options.doublePrecision = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    auto value = argv[++i];
+    if (flag == "--from") {
+      if (!parseRepresentation(value, options.from)) {
+        return false;
+      }
+    } else if (flag == "--to") {
+      if (!parseRepresentation(value, options.to)) {
+        return false;
+      }
+    } else if (flag == "--order") {
+      if (!parseOrder(value, options.fromOrder)) {
+        return false;
+      }
+      options.toOrder = options.fromOrder;
+    } else if (flag == "--from-order") {
+      if (!parseOrder(value, options.fromOrder)) {
+        return false;
+      }
+    } else if (flag == "--to-order") {
+      if (!parseOrder(value, options.toOrder)) {
+        return false;
+      }
+    } else if (flag == "--input") {
+      options.input = value;
+    } else if (flag == "--output") {
+      options.output = value;
+    } else if (flag == "--threads") {
+      auto end = value + std::strlen(value);
+      if (std::from_chars(value, end, options.threads).ptr != end) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return (options.input == nullptr) == (options.output == nullptr);
+}
+
+template <typename T>
+void write(const BasicEulerAngle<T>& e, T* out) {
+  out[0] = e.x;
+  out[1] = e.y;
+  out[2] = e.z;
+}
+
+template <typename T>
+void write(const BasicQuaternion<T>& q, T* out) {
+  out[0] = q.x;
+  out[1] = q.y;
+  out[2] = q.z;
+  out[3] = q.w;
+}
+
+template <typename T>
+void write(const BasicRotationMatrix<T>& m, T* out) {
+  std::copy(m.elements.begin(), m.elements.end(), out);
+}
+
+template <typename T>
+void convert(const Options& options, const T* in, T* out) {
+  switch (options.from) {
+  case Representation::Euler: {
+    BasicEulerAngle<T> e(in[0], in[1], in[2], options.fromOrder);
+    switch (options.to) {
+    case Representation::Euler:
+      write(options.fromOrder == options.toOrder ? e : toEulerAngle(toRotationMatrix(e), options.toOrder), out);
+      break;
+    case Representation::Quaternion:
+      write(toQuaternion(e), out);
+      break;
+    case Representation::Matrix:
+      write(toRotationMatrix(e), out);
+      break;
+    }
+    break;
+  }
+  case Representation::Quaternion: {
+    BasicQuaternion<T> q(in[0], in[1], in[2], in[3]);
+    switch (options.to) {
+    case Representation::Euler:
+      write(toEulerAngle(q, options.toOrder), out);
+      break;
+    case Representation::Quaternion:
+      write(q, out);
+      break;
+    case Representation::Matrix:
+      write(toRotationMatrix(q), out);
+      break;
+    }
+    break;
+  }
+  case Representation::Matrix: {
+    BasicRotationMatrix<T> m({ in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], in[8] });
+    switch (options.to) {
+    case Representation::Euler:
+      write(toEulerAngle(m, options.toOrder), out);
+      break;
+    case Representation::Quaternion:
+      write(toQuaternion(m), out);
+      break;
+    case Representation::Matrix:
+      write(m, out);
+      break;
+    }
+    break;
+  }
+  }
+}
+
+bool isWordCharacter(char c) {
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '.';
+}
+
+// A number may start at a digit, sign or point that does not continue a word, so headers such as "m00" are skipped.
+bool startsNumber(const char* p, const char* lineBegin) {
+  auto c = *p;
+  return ((c >= '0' && c <= '9') || c == '-' || c == '.') && (p == lineBegin || !isWordCharacter(p[-1]));
+}
+
+// Converts the complete lines in [begin, end) and appends the results to output. Returns false and fills error on
+// the first malformed line.
+template <typename T>
+bool convertLines(const Options& options, const char* begin, const char* end, std::string& output, ParseError& error) {
+  auto expected = components(options.from);
+  auto produced = components(options.to);
+  output.reserve(output.size() + 2 * static_cast<size_t>(end - begin));
+  T in[9], out[9];
+  char number[64];
+  for (auto line = begin; line < end;) {
+    auto lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if (lineEnd == nullptr) {
+      lineEnd = end;
+    }
+    size_t count = 0;
+    for (auto p = line; p < lineEnd;) {
+      if (!startsNumber(p, line)) {
+        p++;
+        continue;
+      }
+      if (count == expected) {
+        error = ParseError{ line, "too many numbers" };
+        return false;
+      }
+      auto result = std::from_chars(p, lineEnd, in[count]);
+      if (result.ec == std::errc::invalid_argument) {
+        p++;
+        continue;
+      }
+      if (result.ec != std::errc()) {
+        error = ParseError{ line, "number out of range" };
+        return false;
+      }
+      count++;
+      p = result.ptr;
+    }
+    if (count != 0) {
+      if (count != expected) {
+        error = ParseError{ line, "too few numbers" };
+        return false;
+      }
+      convert(options, in, out);
+      for (size_t i = 0; i < produced; i++) {
+        auto result = std::to_chars(number, number + sizeof(number), out[i]);
+        *result.ptr = i + 1 < produced ? ',' : '\n';
+        output.append(number, result.ptr + 1);
+      }
+    }
+    line = lineEnd + 1;
+  }
+  return true;
+}
+
+// Writes text to out; returns false and reports the error if the write is short.
+bool writeOutput(const std::string& text, FILE* out, FILE* err) {
+  if (std::fwrite(text.data(), 1, text.size(), out) != text.size()) {
+    std::fprintf(err, "convert: %s\n", std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+// Converts a block of complete lines in parallel and writes the results in input order.
+template <typename T>
+bool convertBlock(const Options& options, ThreadPool& pool, const char* begin, const char* end, size_t linesBefore,
+    FILE* out, FILE* err) {
+  auto pieces = pool.threadCount() * PIECES_PER_THREAD;
+  std::vector<const char*> bounds(pieces + 1, end);
+  bounds[0] = begin;
+  for (size_t i = 1; i < pieces; i++) {
+    auto split = std::max(bounds[i - 1], begin + (end - begin) * i / pieces);
+    auto newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+    bounds[i] = newline == nullptr ? end : newline + 1;
+  }
+  std::vector<std::string> outputs(pieces);
+  std::vector<ParseError> errors(pieces);
+  pool.parallelFor(pieces, 1, [&](size_t first, size_t last) {
+    for (auto i = first; i < last; i++) {
+      convertLines<T>(options, bounds[i], bounds[i + 1], outputs[i], errors[i]);
+    }
+  });
+  for (size_t i = 0; i < pieces; i++) {
+    if (errors[i].at != nullptr) {
+      if (!writeOutput(outputs[i], out, err)) {
+        return false;
+      }
+      auto line = linesBefore + std::count(begin, errors[i].at, '\n') + 1;
+      std::fprintf(err, "convert: line %zu: %s\n", line, errors[i].message);
+      return false;
+    }
+    if (!writeOutput(outputs[i], out, err)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+int run(const Options& options, FILE* in, FILE* out, FILE* err) {
+  ThreadPool pool(options.threads);
+  std::vector<char> buffer(BLOCK_SIZE);
+  size_t carry = 0;
+  size_t lines = 0;
+  while (true) {
+    if (carry == buffer.size()) {
+      buffer.resize(2 * buffer.size());
+    }
+    auto read = std::fread(buffer.data() + carry, 1, buffer.size() - carry, in);
+    if (read < buffer.size() - carry && std::ferror(in)) {
+      std::fprintf(err, "convert: %s\n", std::strerror(errno));
+      return 1;
+    }
+    auto size = carry + read;
+    auto eof = read == 0;
+    const char* data = buffer.data();
+    const char* end = data + size;
+    if (!eof) {
+      auto last = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(data), '\n');
+      end = last.base();
+    }
+    if (!convertBlock<T>(options, pool, data, end, lines, out, err)) {
+      return 1;
+    }
+    lines += std::count(data, end, '\n');
+    carry = data + size - end;
+    std::memmove(buffer.data(), end, carry);
+    if (eof) {
+      break;
+    }
+  }
+  if (std::fflush(out) != 0) {
+    std::fprintf(err, "convert: %s\n", std::strerror(errno));
+    return 1;
+  }
+  return 0;
+}
+
+// Runs the converter with the command line in argv, reading lines from in and writing results to out and messages to
+// err. Returns the exit status: 0 on success, 1 on a conversion error and 2 on bad options.
+int convertMain(int argc, char** argv, FILE* in, FILE* out, FILE* err) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::fputs(USAGE, err);
+    return 2;
+  }
+  if (options.input != nullptr) {
+    const RotationKind kinds[] = { RotationKind::EulerAngle, RotationKind::Quaternion, RotationKind::RotationMatrix };
+    try {
+      ThreadPool pool(options.threads);
+      convertRotationFile(pool, options.input, options.output, kinds[static_cast<size_t>(options.to)], options.toOrder);
+    } catch (const char* message) {
+      std::fprintf(err, "convert: %s\n", message);
+      return 1;
+    }
+    return 0;
+  }
+  return options.doublePrecision ? run<double>(options, in, out, err) : run<float>(options, in, out, err);
+}
+
+#endif // __CONVERT_H__
@@ -0,0 +1,7 @@
+#include <cstdio>
+
+#include "./convert.h"
+
+int main(int argc, char** argv) {
+  return convertMain(argc, argv, stdin, stdout, stderr);
+}
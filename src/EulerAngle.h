@@ -10,13 +10,17 @@ enum class EulerOrder {
   ZYX
 };
 
-class EulerAngle {
+template <typename T>
+class BasicEulerAngle {
 public:
-  float x;
-  float y;
-  float z;
+  T x;
+  T y;
+  T z;
   EulerOrder order;
-  EulerAngle(float x, float y, float z, EulerOrder order): x(x), y(y), z(z), order(order) {}
+  constexpr BasicEulerAngle(T x, T y, T z, EulerOrder order): x(x), y(y), z(z), order(order) {}
 };
 
+using EulerAngle = BasicEulerAngle<float>;
+using EulerAngled = BasicEulerAngle<double>;
+
 #endif // __EULERANGLE_H__
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef __EULERANGLECACHE_H__
+#define __EULERANGLECACHE_H__
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./conversion.h"
+
+const size_t EULER_ANGLE_CACHE_DEFAULT_CAPACITY = 4096;
+const size_t EULER_ANGLE_CACHE_MAX_PROBES = 8;
+
+// Fixed-size open-addressing memo of quaternion to euler angle conversions. Keys are the quaternion with w >= 0,
+// quantized to multiples of quantum, plus the order; since the conversion gives the same angles for q and -q, the
+// sign canonicalization is exact, while the quantization means a hit returns the angles of the first quaternion
+// seen within quantum of the queried one. Lookups probe up to EULER_ANGLE_CACHE_MAX_PROBES slots linearly and a
+// miss on a full run evicts its first slot. Quaternions with a component beyond 2 in magnitude or not a number are
+// converted without caching and count as misses.
+template <typename T>
+class BasicEulerAngleCache {
+public:
+  explicit BasicEulerAngleCache(size_t capacity = EULER_ANGLE_CACHE_DEFAULT_CAPACITY, T quantum = T(1) / (1 << 20));
+  BasicEulerAngle<T> toEulerAngle(const BasicQuaternion<T>& q, EulerOrder order);
+  size_t capacity() const { return entries.size(); }
+  size_t hits() const { return hitCount; }
+  size_t misses() const { return missCount; }
+  void resetCounters();
+  // Drops every entry and reallocates for capacity, rounded up to a power of two.
+  void resize(size_t capacity);
+
+private:
+  struct Entry {
+    int32_t key[4];
+    EulerOrder order;
+    bool occupied;
+    T x;
+    T y;
+    T z;
+  };
+  std::vector<Entry> entries;
+  size_t mask;
+  double scale;
+  size_t hitCount;
+  size_t missCount;
+};
+
+using EulerAngleCache = BasicEulerAngleCache<float>;
+
+template <typename T>
+BasicEulerAngleCache<T>::BasicEulerAngleCache(size_t capacity, T quantum): scale(1 / quantum), hitCount(0), missCount(0) {
+  if (!(quantum > 0) || !(4 * scale < INT32_MAX)) {
+    throw "quantum of euler angle cache is out of range.";
+  }
+  resize(capacity);
+}
+
+template <typename T>
+void BasicEulerAngleCache<T>::resetCounters() {
+  hitCount = 0;
+  missCount = 0;
+}
+
+template <typename T>
+void BasicEulerAngleCache<T>::resize(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity) {
+    size *= 2;
+  }
+  entries.assign(size, Entry{ { 0, 0, 0, 0 }, EulerOrder::XYZ, false, 0, 0, 0 });
+  mask = size - 1;
+}
+
+template <typename T>
+BasicEulerAngle<T> BasicEulerAngleCache<T>::toEulerAngle(const BasicQuaternion<T>& q, EulerOrder order) {
+  // Branch-free sign and rounding: the signs of random rotations are unpredictable, so branches there would dominate
+  // the cost of a hit.
+  auto sign = std::copysign(1.0, static_cast<double>(q.w));
+  T components[] = { q.x, q.y, q.z, q.w };
+  int32_t key[4];
+  uint64_t hash = static_cast<uint64_t>(order) + 1;
+  for (size_t i = 0; i < 4; i++) {
+    if (!(std::abs(components[i]) <= 2)) {
+      missCount++;
+      return ::toEulerAngle(q, order);
+    }
+    key[i] = static_cast<int32_t>((sign * components[i] + 2) * scale + 0.5);
+    hash = (hash ^ static_cast<uint32_t>(key[i])) * 0x9e3779b97f4a7c15ull;
+  }
+  auto home = static_cast<size_t>(hash ^ hash >> 29) & mask;
+  auto slot = home;
+  for (size_t probe = 0; probe < EULER_ANGLE_CACHE_MAX_PROBES; probe++) {
+    auto& entry = entries[(home + probe) & mask];
+    if (!entry.occupied) {
+      slot = (home + probe) & mask;
+      break;
+    }
+    if (entry.order == order && entry.key[0] == key[0] && entry.key[1] == key[1] && entry.key[2] == key[2] &&
+        entry.key[3] == key[3]) {
+      hitCount++;
+      return BasicEulerAngle<T>(entry.x, entry.y, entry.z, order);
+    }
+  }
+  missCount++;
+  auto e = ::toEulerAngle(q, order);
+  entries[slot] = Entry{ { key[0], key[1], key[2], key[3] }, order, true, e.x, e.y, e.z };
+  return e;
+}
+
+template <typename T>
+BasicEulerAngleCache<T>& threadEulerAngleCache() {
+  thread_local BasicEulerAngleCache<T> cache;
+  return cache;
+}
+
+// toEulerAngle(q, order) through the calling thread's cache, see threadEulerAngleCache for its counters and size.
+template <typename T>
+BasicEulerAngle<T> toEulerAngleCached(const BasicQuaternion<T>& q, EulerOrder order) {
+  return threadEulerAngleCache<T>().toEulerAngle(q, order);
+}
+
+#endif // __EULERANGLECACHE_H__
@@ -0,0 +1,118 @@
+#ifndef __EULERANGLESTREAM_H__
+#define __EULERANGLESTREAM_H__
+
+#include <cmath>
+#include <cstddef>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./conversion.h"
+
+// Euler angle extraction for a time series of rotations. Each frame is converted as usual and then replaced by the
+// equivalent triple closest to the previous frame's result: the other branch (first + PI, PI - middle, third + PI) is
+// considered and every angle is shifted by whole turns, so outputs are continuous without a separate unwrap pass.
+// In gimbal lock, where only first +- third is determined, the previous third angle is kept and the first angle takes
+// the rest of the rotation. The first frame after construction or reset is returned unchanged.
+template <typename T>
+class BasicEulerAngleStream {
+public:
+  explicit BasicEulerAngleStream(EulerOrder order);
+  BasicEulerAngle<T> next(const BasicQuaternion<T>& q);
+  BasicEulerAngle<T> next(const BasicRotationMatrix<T>& m);
+  void reset() { started = false; }
+
+private:
+  EulerOrder order;
+  size_t axes[3];
+  T parity;
+  bool started;
+  T previous[3];
+  BasicEulerAngle<T> follow(const BasicEulerAngle<T>& e, bool locked);
+};
+
+using EulerAngleStream = BasicEulerAngleStream<float>;
+using EulerAngleStreamd = BasicEulerAngleStream<double>;
+
+template <typename T>
+BasicEulerAngleStream<T>::BasicEulerAngleStream(EulerOrder order): order(order), started(false) {
+  // Field index (0 = x, 1 = y, 2 = z) of the first, middle and third angle, and +1 for cyclic orders.
+  static const size_t orderAxes[][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+  static const int orderParity[] = { 1, -1, -1, 1, 1, -1 };
+  auto index = static_cast<size_t>(order);
+  if (index >= sizeof(orderParity) / sizeof(orderParity[0])) {
+    throw "euler order is invalid.";
+  }
+  for (size_t i = 0; i < 3; i++) {
+    axes[i] = orderAxes[index][i];
+  }
+  parity = static_cast<T>(orderParity[index]);
+}
+
+template <typename T>
+BasicEulerAngle<T> BasicEulerAngleStream<T>::next(const BasicQuaternion<T>& q) {
+  return withEulerOrder(order, [&](auto o) {
+    return follow(toEulerAngle<decltype(o)::value>(q), isGimbalLocked<decltype(o)::value>(q));
+  });
+}
+
+template <typename T>
+BasicEulerAngle<T> BasicEulerAngleStream<T>::next(const BasicRotationMatrix<T>& m) {
+  return withEulerOrder(order, [&](auto o) {
+    return follow(toEulerAngle<decltype(o)::value>(m), isGimbalLocked<decltype(o)::value>(m));
+  });
+}
+
+// Shifts angle by whole turns to the nearest value to reference.
+template <typename T>
+T unwrapAngle(T angle, T reference) {
+  const T turn = static_cast<T>(2 * constexprMath::PI);
+  return angle + turn * std::round((reference - angle) / turn);
+}
+
+template <typename T>
+BasicEulerAngle<T> BasicEulerAngleStream<T>::follow(const BasicEulerAngle<T>& e, bool locked) {
+  const T pi = static_cast<T>(constexprMath::PI);
+  T fields[] = { e.x, e.y, e.z };
+  T current[] = { fields[axes[0]], fields[axes[1]], fields[axes[2]] };
+  if (started) {
+    if (locked) {
+      // Rotating the first angle by -sign * t and the third by t leaves the rotation unchanged in lock.
+      auto sign = current[1] < 0 ? -parity : parity;
+      current[0] = unwrapAngle(current[0] - sign * previous[2], previous[0]);
+      current[1] = unwrapAngle(current[1], previous[1]);
+      current[2] = previous[2];
+    } else {
+      T other[] = { current[0] + pi, pi - current[1], current[2] + pi };
+      T distance = 0, otherDistance = 0;
+      for (size_t i = 0; i < 3; i++) {
+        current[i] = unwrapAngle(current[i], previous[i]);
+        other[i] = unwrapAngle(other[i], previous[i]);
+        distance += (current[i] - previous[i]) * (current[i] - previous[i]);
+        otherDistance += (other[i] - previous[i]) * (other[i] - previous[i]);
+      }
+      if (otherDistance < distance) {
+        for (size_t i = 0; i < 3; i++) {
+          current[i] = other[i];
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < 3; i++) {
+    previous[i] = current[i];
+    fields[axes[i]] = current[i];
+  }
+  started = true;
+  return BasicEulerAngle<T>(fields[0], fields[1], fields[2], order);
+}
+
+// Converts count rotations of a time series with one stream, see BasicEulerAngleStream.
+template <class R, typename T>
+void toEulerAngleStream(const R* rotations, size_t count, EulerOrder order, BasicEulerAngle<T>* result) {
+  BasicEulerAngleStream<T> stream(order);
+  for (size_t i = 0; i < count; i++) {
+    result[i] = stream.next(rotations[i]);
+  }
+}
+
+#endif // __EULERANGLESTREAM_H__
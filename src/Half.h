@@ -0,0 +1,75 @@
+#ifndef __HALF_H__
+#define __HALF_H__
+
+#include <cstdint>
+#include <cstring>
+
+uint32_t floatBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Round-to-nearest-even like F16C, including subnormals, infinities and NaN.
+uint16_t floatToHalfBits(float value) {
+  auto x = floatBits(value);
+  auto sign = x & 0x80000000u;
+  x ^= sign;
+  uint32_t h;
+  if (x >= 0x47800000u) {
+    h = x > 0x7f800000u ? 0x7e00 : 0x7c00;
+  } else if (x < 0x38800000u) {
+    h = floatBits(bitsFloat(x) + 0.5f) - 0x3f000000u;
+  } else {
+    h = (x + 0xc8000fffu + ((x >> 13) & 1)) >> 13;
+  }
+  return static_cast<uint16_t>(h | (sign >> 16));
+}
+
+float halfBitsToFloat(uint16_t h) {
+  uint32_t x = static_cast<uint32_t>(h & 0x7fff) << 13;
+  auto exponent = x & 0x0f800000u;
+  x += 0x38000000u;
+  if (exponent == 0x0f800000u) {
+    x += 0x38000000u;
+  } else if (exponent == 0) {
+    x = floatBits(bitsFloat(x + 0x00800000u) - bitsFloat(0x38800000u));
+  }
+  return bitsFloat(x | static_cast<uint32_t>(h & 0x8000) << 16);
+}
+
+uint16_t floatToBFloat16Bits(float value) {
+  auto x = floatBits(value);
+  if ((x & 0x7fffffffu) > 0x7f800000u) {
+    return static_cast<uint16_t>((x >> 16) | 0x40);
+  }
+  return static_cast<uint16_t>((x + 0x7fffu + ((x >> 16) & 1)) >> 16);
+}
+
+float bFloat16BitsToFloat(uint16_t b) {
+  return bitsFloat(static_cast<uint32_t>(b) << 16);
+}
+
+class Half {
+public:
+  uint16_t bits;
+  Half(): bits(0) {}
+  explicit Half(float value): bits(floatToHalfBits(value)) {}
+  explicit operator float() const { return halfBitsToFloat(bits); }
+};
+
+class BFloat16 {
+public:
+  uint16_t bits;
+  BFloat16(): bits(0) {}
+  explicit BFloat16(float value): bits(floatToBFloat16Bits(value)) {}
+  explicit operator float() const { return bFloat16BitsToFloat(bits); }
+};
+
+#endif // __HALF_H__
@@ -5,38 +5,101 @@
 
 #include "./Vector3.h"
 
-class Quaternion {
+template <typename T>
+class BasicQuaternion {
 public:
-  float x;
-  float y;
-  float z;
-  float w;
-  Quaternion(float x, float y, float z, float w): x(x), y(y),z(z), w(w) {}
-  static Quaternion rotationX(float angle);
-  static Quaternion rotationY(float angle);
-  static Quaternion rotationZ(float angle);
-  Quaternion operator*(const Quaternion q) const;
-  Vector3 rotate(const Vector3 v) const;
+  T x;
+  T y;
+  T z;
+  T w;
+  constexpr BasicQuaternion(T x, T y, T z, T w): x(x), y(y),z(z), w(w) {}
+  static BasicQuaternion rotationX(T angle);
+  static BasicQuaternion rotationY(T angle);
+  static BasicQuaternion rotationZ(T angle);
+  BasicQuaternion operator*(const BasicQuaternion q) const;
+  BasicVector3<T> rotate(const BasicVector3<T> v) const;
 };
 
-Quaternion Quaternion::rotationX(float angle) {
-  return Quaternion(std::sin(0.5f * angle), 0, 0, std::cos(0.5f * angle));
+using Quaternion = BasicQuaternion<float>;
+using Quaterniond = BasicQuaternion<double>;
+
+template <typename T>
+BasicQuaternion<T> BasicQuaternion<T>::rotationX(T angle) {
+  return BasicQuaternion(std::sin(0.5f * angle), 0, 0, std::cos(0.5f * angle));
+}
+
+template <typename T>
+BasicQuaternion<T> BasicQuaternion<T>::rotationY(T angle) {
+  return BasicQuaternion(0, std::sin(0.5f * angle), 0, std::cos(0.5f * angle));
+}
+
+template <typename T>
+BasicQuaternion<T> BasicQuaternion<T>::rotationZ(T angle) {
+  return BasicQuaternion(0, 0, std::sin(0.5f * angle), std::cos(0.5f * angle));
+}
+
+template <typename T>
+BasicQuaternion<T> conjugate(const BasicQuaternion<T> q) {
+  return BasicQuaternion<T>(-q.x, -q.y, -q.z, q.w);
+}
+
+template <typename T>
+T dot(const BasicQuaternion<T> a, const BasicQuaternion<T> b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
 
-Quaternion Quaternion::rotationY(float angle) {
-  return Quaternion(0, std::sin(0.5f * angle), 0, std::cos(0.5f * angle));
+// Unit quaternion in the direction of q, which must not be zero.
+template <typename T>
+BasicQuaternion<T> normalize(const BasicQuaternion<T> q) {
+  auto inverseLength = 1 / std::sqrt(dot(q, q));
+  return BasicQuaternion<T>(q.x * inverseLength, q.y * inverseLength, q.z * inverseLength, q.w * inverseLength);
 }
 
-Quaternion Quaternion::rotationZ(float angle) {
-  return Quaternion(0, 0, std::sin(0.5f * angle), std::cos(0.5f * angle));
+// The one of q and -q, which are the same rotation, with w >= 0 (w of +0 when it is zero), as a unique key for
+// hashing and compression.
+template <typename T>
+BasicQuaternion<T> canonicalize(const BasicQuaternion<T> q) {
+  return std::signbit(q.w) ? BasicQuaternion<T>(-q.x, -q.y, -q.z, -q.w) : q;
 }
 
-Quaternion conjugate(const Quaternion q) {
-  return Quaternion(-q.x, -q.y, -q.z, q.w);
+// Interpolations from a (t = 0) to b (t = 1) along the shorter arc, b being negated when dot(a, b) < 0. Both return
+// unit quaternions. slerp has constant angular velocity and falls back to nlerp when the keys are nearly parallel;
+// nlerp is the normalized linear blend, cheaper but with an angular velocity peaking mid-arc.
+template <typename T>
+BasicQuaternion<T> nlerp(const BasicQuaternion<T> a, const BasicQuaternion<T> b, T t) {
+  auto wb = dot(a, b) < 0 ? -t : t;
+  auto wa = 1 - t;
+  auto x = wa * a.x + wb * b.x;
+  auto y = wa * a.y + wb * b.y;
+  auto z = wa * a.z + wb * b.z;
+  auto w = wa * a.w + wb * b.w;
+  auto inverseLength = 1 / std::sqrt(x * x + y * y + z * z + w * w);
+  return BasicQuaternion<T>(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
 }
 
-Quaternion Quaternion::operator*(const Quaternion q) const {
-  return Quaternion(
+template <typename T>
+BasicQuaternion<T> slerp(const BasicQuaternion<T> a, const BasicQuaternion<T> b, T t) {
+  auto d = dot(a, b);
+  T sign = d < 0 ? -1 : 1;
+  d *= sign;
+  if (d > static_cast<T>(0.9995)) {
+    return nlerp(a, b, t);
+  }
+  auto sinTheta = std::sqrt(1 - d * d);
+  auto theta = std::atan2(sinTheta, d);
+  auto wa = std::sin((1 - t) * theta) / sinTheta;
+  auto wb = sign * std::sin(t * theta) / sinTheta;
+  auto x = wa * a.x + wb * b.x;
+  auto y = wa * a.y + wb * b.y;
+  auto z = wa * a.z + wb * b.z;
+  auto w = wa * a.w + wb * b.w;
+  auto inverseLength = 1 / std::sqrt(x * x + y * y + z * z + w * w);
+  return BasicQuaternion<T>(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+}
+
+template <typename T>
+BasicQuaternion<T> BasicQuaternion<T>::operator*(const BasicQuaternion q) const {
+  return BasicQuaternion(
     w * q.x - z * q.y + y * q.z + x * q.w,
     z * q.x + w * q.y - x * q.z + y * q.w,
     -y * q.x + x * q.y + w * q.z + z * q.w,
@@ -44,11 +107,16 @@ Quaternion Quaternion::operator*(const Quaternion q) const {
   );
 }
 
-Vector3 Quaternion::rotate(const Vector3 v) const {
-  auto vq = Quaternion(v.x, v.y, v.z, 0);
-  auto cq = conjugate(*this);
-  auto mq = *this * vq * cq;
-  return Vector3(mq.x, mq.y, mq.z);
+template <typename T>
+BasicVector3<T> BasicQuaternion<T>::rotate(const BasicVector3<T> v) const {
+  auto tx = 2 * (y * v.z - z * v.y);
+  auto ty = 2 * (z * v.x - x * v.z);
+  auto tz = 2 * (x * v.y - y * v.x);
+  return BasicVector3<T>(
+    v.x + w * tx + y * tz - z * ty,
+    v.y + w * ty + z * tx - x * tz,
+    v.z + w * tz + x * ty - y * tx
+  );
 }
 
 #endif // __QUATERNION_H__
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef __QUATERNIONCODEC_H__
+#define __QUATERNIONCODEC_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./Quaternion.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./quaternionCodecKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// Smallest-three compressed unit quaternions. The largest component is dropped and restored from the unit length;
+// its index takes 2 bits and the other three components are quantized over [-1/sqrt(2), 1/sqrt(2)]. Since q and -q
+// are the same rotation, decoding may return the negated quaternion.
+
+// 2-bit index and 3 x 10-bit components, about 7e-4 maximum error per component.
+class PackedQuaternion32 {
+public:
+  uint32_t bits;
+};
+
+// 2-bit index and 3 x 15-bit components in 6 bytes, about 2e-5 maximum error per component.
+class PackedQuaternion48 {
+public:
+  uint16_t bits[3];
+};
+
+template <class P>
+class SmallestThree;
+
+template <>
+class SmallestThree<PackedQuaternion32> {
+public:
+  static const uint32_t componentBits = 10;
+  static PackedQuaternion32 pack(uint32_t index, uint32_t a, uint32_t b, uint32_t c) {
+    return PackedQuaternion32{ index << 30 | a << 20 | b << 10 | c };
+  }
+  static void unpack(PackedQuaternion32 p, uint32_t& index, uint32_t& a, uint32_t& b, uint32_t& c) {
+    index = p.bits >> 30;
+    a = p.bits >> 20 & 0x3ff;
+    b = p.bits >> 10 & 0x3ff;
+    c = p.bits & 0x3ff;
+  }
+};
+
+template <>
+class SmallestThree<PackedQuaternion48> {
+public:
+  static const uint32_t componentBits = 15;
+  static PackedQuaternion48 pack(uint32_t index, uint32_t a, uint32_t b, uint32_t c) {
+    auto bits = static_cast<uint64_t>(index) << 45 | static_cast<uint64_t>(a) << 30 | b << 15 | c;
+    return PackedQuaternion48{ { static_cast<uint16_t>(bits), static_cast<uint16_t>(bits >> 16), static_cast<uint16_t>(bits >> 32) } };
+  }
+  static void unpack(PackedQuaternion48 p, uint32_t& index, uint32_t& a, uint32_t& b, uint32_t& c) {
+    auto bits = static_cast<uint64_t>(p.bits[0]) | static_cast<uint64_t>(p.bits[1]) << 16 | static_cast<uint64_t>(p.bits[2]) << 32;
+    index = static_cast<uint32_t>(bits >> 45);
+    a = static_cast<uint32_t>(bits >> 30 & 0x7fff);
+    b = static_cast<uint32_t>(bits >> 15 & 0x7fff);
+    c = static_cast<uint32_t>(bits & 0x7fff);
+  }
+};
+
+void quantizeSmallestThree(const float* x, const float* y, const float* z, const float* w, size_t count, float levels,
+    float* index, float* a, float* b, float* c) {
+  SIMD_DISPATCH(quantizeSmallestThreeBatch, x, y, z, w, count, levels, index, a, b, c);
+}
+
+void dequantizeSmallestThree(const float* index, const float* a, const float* b, const float* c, size_t count,
+    float levels, float* x, float* y, float* z, float* w) {
+  SIMD_DISPATCH(dequantizeSmallestThreeBatch, index, a, b, c, count, levels, x, y, z, w);
+}
+
+const size_t CODEC_CHUNK = 256;
+
+// Quantization runs in float lanes on chunks of CODEC_CHUNK quaternions; packing the quantized values into bits is
+// a separate integer loop over the chunk.
+template <class P>
+void encodeQuaternionBatch(const float* x, const float* y, const float* z, const float* w, size_t count, P* result) {
+  auto levels = static_cast<float>((1u << SmallestThree<P>::componentBits) - 1);
+  float index[CODEC_CHUNK], a[CODEC_CHUNK], b[CODEC_CHUNK], c[CODEC_CHUNK];
+  for (size_t i = 0; i < count; i += CODEC_CHUNK) {
+    auto n = count - i < CODEC_CHUNK ? count - i : CODEC_CHUNK;
+    quantizeSmallestThree(x + i, y + i, z + i, w + i, n, levels, index, a, b, c);
+    for (size_t j = 0; j < n; j++) {
+      result[i + j] = SmallestThree<P>::pack(static_cast<uint32_t>(index[j]), static_cast<uint32_t>(a[j]),
+        static_cast<uint32_t>(b[j]), static_cast<uint32_t>(c[j]));
+    }
+  }
+}
+
+template <class P>
+void decodeQuaternionBatch(const P* packed, size_t count, float* x, float* y, float* z, float* w) {
+  auto levels = static_cast<float>((1u << SmallestThree<P>::componentBits) - 1);
+  float index[CODEC_CHUNK], a[CODEC_CHUNK], b[CODEC_CHUNK], c[CODEC_CHUNK];
+  for (size_t i = 0; i < count; i += CODEC_CHUNK) {
+    auto n = count - i < CODEC_CHUNK ? count - i : CODEC_CHUNK;
+    for (size_t j = 0; j < n; j++) {
+      uint32_t qi, qa, qb, qc;
+      SmallestThree<P>::unpack(packed[i + j], qi, qa, qb, qc);
+      index[j] = static_cast<float>(qi);
+      a[j] = static_cast<float>(qa);
+      b[j] = static_cast<float>(qb);
+      c[j] = static_cast<float>(qc);
+    }
+    dequantizeSmallestThree(index, a, b, c, n, levels, x + i, y + i, z + i, w + i);
+  }
+}
+
+template <class P>
+P encodeQuaternion(const Quaternion q) {
+  P result;
+  encodeQuaternionBatch(&q.x, &q.y, &q.z, &q.w, 1, &result);
+  return result;
+}
+
+PackedQuaternion32 encodeQuaternion32(const Quaternion q) {
+  return encodeQuaternion<PackedQuaternion32>(q);
+}
+
+PackedQuaternion48 encodeQuaternion48(const Quaternion q) {
+  return encodeQuaternion<PackedQuaternion48>(q);
+}
+
+template <class P>
+Quaternion decodeQuaternion(const P p) {
+  Quaternion q(0, 0, 0, 1);
+  decodeQuaternionBatch(&p, 1, &q.x, &q.y, &q.z, &q.w);
+  return q;
+}
+
+#endif // __QUATERNIONCODEC_H__
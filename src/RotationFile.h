@@ -0,0 +1,221 @@
+#ifndef __ROTATIONFILE_H__
+#define __ROTATIONFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+
+enum class RotationKind : uint32_t {
+  EulerAngle,
+  Quaternion,
+  RotationMatrix
+};
+
+// Packed binary rotation file: this header, then count records from dataOffset on, each stored with the in-memory
+// layout of BasicEulerAngle<T>, BasicQuaternion<T> or BasicRotationMatrix<T> in native byte order. A mapped file can
+// therefore be used directly as an array of records.
+class RotationFileHeader {
+public:
+  char magic[8];
+  uint32_t version;
+  RotationKind kind;
+  uint32_t scalarSize;
+  uint32_t stride;
+  uint64_t count;
+  uint64_t dataOffset;
+};
+
+const char ROTATION_FILE_MAGIC[8] = { 'R', 'O', 'T', 'F', 'I', 'L', 'E', '\0' };
+const uint32_t ROTATION_FILE_VERSION = 1;
+const uint64_t ROTATION_FILE_DATA_OFFSET = 64;
+
+template <class R>
+class RotationRecord;
+
+// size is the number of bytes holding fields; the rest of the stride is padding, which is kept zero in files.
+template <typename T>
+class RotationRecord<BasicEulerAngle<T>> {
+public:
+  using Scalar = T;
+  static const RotationKind kind = RotationKind::EulerAngle;
+  static const size_t size = offsetof(BasicEulerAngle<T>, order) + sizeof(EulerOrder);
+};
+
+template <typename T>
+class RotationRecord<BasicQuaternion<T>> {
+public:
+  using Scalar = T;
+  static const RotationKind kind = RotationKind::Quaternion;
+  static const size_t size = sizeof(BasicQuaternion<T>);
+};
+
+template <typename T>
+class RotationRecord<BasicRotationMatrix<T>> {
+public:
+  using Scalar = T;
+  static const RotationKind kind = RotationKind::RotationMatrix;
+  static const size_t size = sizeof(BasicRotationMatrix<T>);
+};
+
+// Copies the fields of record into a zero-filled file record, leaving its padding zero.
+template <class R>
+void storeRotationRecord(R* to, const R& record) {
+  std::memcpy(static_cast<void*>(to), &record, RotationRecord<R>::size);
+}
+
+template <class R>
+RotationFileHeader rotationFileHeader(uint64_t count) {
+  static_assert(std::is_trivially_copyable<R>::value, "records must be trivially copyable.");
+  RotationFileHeader header;
+  std::memcpy(header.magic, ROTATION_FILE_MAGIC, sizeof(header.magic));
+  header.version = ROTATION_FILE_VERSION;
+  header.kind = RotationRecord<R>::kind;
+  header.scalarSize = sizeof(typename RotationRecord<R>::Scalar);
+  header.stride = sizeof(R);
+  header.count = count;
+  header.dataOffset = ROTATION_FILE_DATA_OFFSET;
+  return header;
+}
+
+// Memory mapping of a whole file, read-only for existing files or read-write for files created with a given size.
+class MappedFile {
+public:
+  explicit MappedFile(const char* path);
+  MappedFile(const char* path, size_t size);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  char* data() const { return bytes; }
+  size_t size() const { return length; }
+  // Writes modified pages of a read-write mapping back to the file and waits for it.
+  void sync() const;
+
+private:
+  char* bytes;
+  size_t length;
+};
+
+MappedFile::MappedFile(const char* path) {
+  auto fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    throw "opening of rotation file is failed.";
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size == 0) {
+    close(fd);
+    throw "opening of rotation file is failed.";
+  }
+  length = static_cast<size_t>(status.st_size);
+  auto mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw "mapping of rotation file is failed.";
+  }
+  bytes = static_cast<char*>(mapping);
+  madvise(bytes, length, MADV_SEQUENTIAL);
+}
+
+MappedFile::MappedFile(const char* path, size_t size): length(size) {
+  auto fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw "creation of rotation file is failed.";
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    close(fd);
+    throw "creation of rotation file is failed.";
+  }
+  auto mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw "mapping of rotation file is failed.";
+  }
+  bytes = static_cast<char*>(mapping);
+}
+
+void MappedFile::sync() const {
+  if (msync(bytes, length, MS_SYNC) != 0) {
+    throw "writing of rotation file is failed.";
+  }
+}
+
+MappedFile::~MappedFile() {
+  munmap(bytes, length);
+}
+
+// Read-only view of a rotation file. The header is validated against the file size when opening.
+class RotationFile {
+public:
+  explicit RotationFile(const char* path);
+  const RotationFileHeader& header() const { return *reinterpret_cast<const RotationFileHeader*>(file.data()); }
+  // Records as an array of R; throws if the file holds another record type.
+  template <class R>
+  const R* records() const;
+
+private:
+  MappedFile file;
+};
+
+RotationFile::RotationFile(const char* path): file(path) {
+  if (file.size() < ROTATION_FILE_DATA_OFFSET) {
+    throw "rotation file is broken.";
+  }
+  auto& h = header();
+  if (std::memcmp(h.magic, ROTATION_FILE_MAGIC, sizeof(h.magic)) != 0 || h.version != ROTATION_FILE_VERSION) {
+    throw "rotation file is broken.";
+  }
+  if (h.dataOffset < ROTATION_FILE_DATA_OFFSET || h.dataOffset % 8 != 0 || h.dataOffset > file.size() ||
+      h.stride == 0 || h.count > (file.size() - h.dataOffset) / h.stride) {
+    throw "rotation file is broken.";
+  }
+}
+
+template <class R>
+const R* RotationFile::records() const {
+  auto expected = rotationFileHeader<R>(0);
+  auto& h = header();
+  if (h.kind != expected.kind || h.scalarSize != expected.scalarSize || h.stride != expected.stride) {
+    throw "record type does not match rotation file.";
+  }
+  return reinterpret_cast<const R*>(file.data() + h.dataOffset);
+}
+
+// Creates path sized for count records of type R, writes the header and returns the mapping; records start at
+// ROTATION_FILE_DATA_OFFSET and are filled in place by the caller.
+template <class R>
+std::unique_ptr<MappedFile> createRotationFile(const char* path, size_t count) {
+  std::unique_ptr<MappedFile> file(new MappedFile(path, ROTATION_FILE_DATA_OFFSET + count * sizeof(R)));
+  auto header = rotationFileHeader<R>(count);
+  std::memcpy(file->data(), &header, sizeof(header));
+  return file;
+}
+
+template <class R>
+void writeRotationFile(const char* path, const R* records, size_t count) {
+  auto file = createRotationFile<R>(path, count);
+  auto data = reinterpret_cast<R*>(file->data() + ROTATION_FILE_DATA_OFFSET);
+  for (size_t i = 0; i < count; i++) {
+    storeRotationRecord(data + i, records[i]);
+  }
+}
+
+// Whether both paths name the same existing file, including through links.
+bool isSameFile(const char* a, const char* b) {
+  struct stat statusA, statusB;
+  if (stat(a, &statusA) != 0 || stat(b, &statusB) != 0) {
+    return false;
+  }
+  return statusA.st_dev == statusB.st_dev && statusA.st_ino == statusB.st_ino;
+}
+
+#endif // __ROTATIONFILE_H__
@@ -6,51 +6,61 @@
 
 #include "./Vector3.h"
 
-class RotationMatrix {
+template <typename T>
+class BasicRotationMatrix {
 public:
-  std::array<float, 9> elements;
-  RotationMatrix(std::array<float, 9> elements): elements(elements) {}
-  static RotationMatrix rotationX(float angle);
-  static RotationMatrix rotationY(float angle);
-  static RotationMatrix rotationZ(float angle);
-  RotationMatrix operator*(const RotationMatrix m) const;
-  Vector3 operator*(const Vector3 v) const;
-  float& operator[](const size_t index);
-  float& at(const size_t row, const size_t column);
+  std::array<T, 9> elements;
+  constexpr BasicRotationMatrix(std::array<T, 9> elements): elements(elements) {}
+  static BasicRotationMatrix rotationX(T angle);
+  static BasicRotationMatrix rotationY(T angle);
+  static BasicRotationMatrix rotationZ(T angle);
+  BasicRotationMatrix operator*(const BasicRotationMatrix m) const;
+  BasicVector3<T> operator*(const BasicVector3<T> v) const;
+  constexpr T& operator[](const size_t index);
+  constexpr const T& operator[](const size_t index) const;
+  constexpr T& at(const size_t row, const size_t column);
+  constexpr const T& at(const size_t row, const size_t column) const;
 };
 
-RotationMatrix RotationMatrix::rotationX(float angle) {
+using RotationMatrix = BasicRotationMatrix<float>;
+using RotationMatrixd = BasicRotationMatrix<double>;
+
+template <typename T>
+BasicRotationMatrix<T> BasicRotationMatrix<T>::rotationX(T angle) {
   auto c = std::cos(angle);
   auto s = std::sin(angle);
-  return RotationMatrix({
+  return BasicRotationMatrix({
     1, 0, 0,
     0, c, s,
     0, -s, c
   });
 }
 
-RotationMatrix RotationMatrix::rotationY(float angle) {
+template <typename T>
+BasicRotationMatrix<T> BasicRotationMatrix<T>::rotationY(T angle) {
   auto c = std::cos(angle);
   auto s = std::sin(angle);
-  return RotationMatrix({
+  return BasicRotationMatrix({
     c, 0, -s,
     0, 1, 0,
     s, 0, c
   });
 }
 
-RotationMatrix RotationMatrix::rotationZ(float angle) {
+template <typename T>
+BasicRotationMatrix<T> BasicRotationMatrix<T>::rotationZ(T angle) {
   auto c = std::cos(angle);
   auto s = std::sin(angle);
-  return RotationMatrix({
+  return BasicRotationMatrix({
     c, s, 0,
     -s, c, 0,
     0, 0, 1
   });
 }
 
-RotationMatrix RotationMatrix::operator*(const RotationMatrix m) const {
-  return RotationMatrix({
+template <typename T>
+BasicRotationMatrix<T> BasicRotationMatrix<T>::operator*(const BasicRotationMatrix m) const {
+  return BasicRotationMatrix({
     elements[0] * m.elements[0] + elements[3] * m.elements[1] + elements[6] * m.elements[2],
     elements[1] * m.elements[0] + elements[4] * m.elements[1] + elements[7] * m.elements[2],
     elements[2] * m.elements[0] + elements[5] * m.elements[1] + elements[8] * m.elements[2],
@@ -63,19 +73,32 @@ RotationMatrix RotationMatrix::operator*(const RotationMatrix m) const {
   });
 }
 
-Vector3 RotationMatrix::operator*(const Vector3 v) const {
-  return Vector3(
+template <typename T>
+BasicVector3<T> BasicRotationMatrix<T>::operator*(const BasicVector3<T> v) const {
+  return BasicVector3<T>(
     elements[0] * v.x + elements[3] * v.y + elements[6] * v.z,
     elements[1] * v.x + elements[4] * v.y + elements[7] * v.z,
     elements[2] * v.x + elements[5] * v.y + elements[8] * v.z
   );
 }
 
-float& RotationMatrix::operator[](const size_t index) {
+template <typename T>
+constexpr T& BasicRotationMatrix<T>::operator[](const size_t index) {
+  return elements[index];
+}
+
+template <typename T>
+constexpr const T& BasicRotationMatrix<T>::operator[](const size_t index) const {
   return elements[index];
 }
 
-float& RotationMatrix::at(const size_t row, const size_t column) {
+template <typename T>
+constexpr T& BasicRotationMatrix<T>::at(const size_t row, const size_t column) {
+  return elements[row + column * 3];
+}
+
+template <typename T>
+constexpr const T& BasicRotationMatrix<T>::at(const size_t row, const size_t column) const {
   return elements[row + column * 3];
 }
 
@@ -0,0 +1,149 @@
+#ifndef __SINCOSTABLE_H__
+#define __SINCOSTABLE_H__
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./conversion.h"
+
+const size_t SIN_COS_TABLE_DEFAULT_BUDGET = 1 << 20;
+
+// Sines and cosines of half angles for euler angles on a grid of stepsPerTurn steps per full turn, e.g. 36000 for a
+// 0.01 degree grid. An angle is on the grid when it is within a few ulp of T from a multiple of the step; those are
+// looked up and any other angle is computed with libm. The table stores interleaved (sin, cos) pairs over the whole
+// period of the half angle when that fits in memoryBudget bytes, otherwise only sines over a quarter turn, at the cost
+// of a few more branches per lookup. Throws if even the quarter table does not fit.
+//
+// Only for double: double libm trig is slow enough for the lookup to pay off (about 2x), while float trig is as fast
+// as the full table and faster than the quarter one, which would only cost cache.
+template <typename T>
+class BasicSinCosTable {
+  static_assert(std::is_same_v<T, double>, "sin cos tables are only faster than exact trig for double.");
+
+public:
+  BasicSinCosTable(size_t stepsPerTurn, size_t memoryBudget = SIN_COS_TABLE_DEFAULT_BUDGET);
+  size_t stepsPerTurn() const { return steps; }
+  size_t memoryUsage() const { return values.size() * sizeof(T); }
+  // Sets s and c to the sine and cosine of angle / 2.
+  void halfSinCos(T angle, T& s, T& c) const;
+
+private:
+  void lookup(T angle, T& s, T& c) const;
+  size_t steps;
+  bool interleaved;
+  double stepsPerRadian;
+  std::vector<T> values;
+};
+
+using SinCosTabled = BasicSinCosTable<double>;
+
+template <typename T>
+BasicSinCosTable<T>::BasicSinCosTable(size_t stepsPerTurn, size_t memoryBudget):
+    steps(stepsPerTurn), stepsPerRadian(stepsPerTurn / (2 * constexprMath::PI)) {
+  if (steps == 0) {
+    throw "sin cos table needs at least one step per turn.";
+  }
+  // Entry k holds the half angle k * PI / steps.
+  if (4 * steps * sizeof(T) <= memoryBudget) {
+    interleaved = true;
+    values.resize(4 * steps);
+    for (size_t k = 0; k < 2 * steps; k++) {
+      values[2 * k] = static_cast<T>(std::sin(k * constexprMath::PI / steps));
+      values[2 * k + 1] = static_cast<T>(std::cos(k * constexprMath::PI / steps));
+    }
+  } else if (steps % 2 == 0 && (steps / 2 + 1) * sizeof(T) <= memoryBudget) {
+    interleaved = false;
+    values.resize(steps / 2 + 1);
+    for (size_t k = 0; k <= steps / 2; k++) {
+      values[k] = static_cast<T>(std::sin(k * constexprMath::PI / steps));
+    }
+  } else {
+    throw "sin cos table does not fit in memory budget.";
+  }
+}
+
+// The common case of an on-grid angle within one turn and a full table is kept small enough to be inlined. Angles
+// that are not finite or too large to round to a step index go to lookup before any conversion to an integer.
+template <typename T>
+void BasicSinCosTable<T>::halfSinCos(T angle, T& s, T& c) const {
+  auto t = angle * stepsPerRadian;
+  if (!(std::abs(t) < 1e15)) {
+    lookup(angle, s, c);
+    return;
+  }
+  auto k = static_cast<long long>(t < 0 ? t - 0.5 : t + 0.5);
+  auto i = static_cast<size_t>(k < 0 ? k + 2 * static_cast<long long>(steps) : k);
+  auto tolerance = 4 * std::numeric_limits<T>::epsilon() * (std::abs(t) > 1 ? std::abs(t) : 1);
+  if (interleaved && i < 2 * steps && std::abs(t - k) <= tolerance) {
+    s = values[2 * i];
+    c = values[2 * i + 1];
+  } else {
+    lookup(angle, s, c);
+  }
+}
+
+template <typename T>
+void BasicSinCosTable<T>::lookup(T angle, T& s, T& c) const {
+  auto t = angle * stepsPerRadian;
+  if (!(std::abs(t) < 1e15)) {
+    s = std::sin(angle * static_cast<T>(0.5));
+    c = std::cos(angle * static_cast<T>(0.5));
+    return;
+  }
+  auto k = static_cast<long long>(t < 0 ? t - 0.5 : t + 0.5);
+  auto tolerance = 4 * std::numeric_limits<T>::epsilon() * (std::abs(t) > 1 ? std::abs(t) : 1);
+  if (!(std::abs(t - k) <= tolerance)) {
+    s = std::sin(angle * static_cast<T>(0.5));
+    c = std::cos(angle * static_cast<T>(0.5));
+    return;
+  }
+  // Half angles repeat every 2 * steps entries.
+  auto period = static_cast<long long>(2 * steps);
+  auto index = k < 0 ? k + period : k;
+  if (index < 0 || index >= period) {
+    index %= period;
+    index = index < 0 ? index + period : index;
+  }
+  auto i = static_cast<size_t>(index);
+  if (interleaved) {
+    s = values[2 * i];
+    c = values[2 * i + 1];
+    return;
+  }
+  // Quarter table: fold the half angle into [0, PI / 2] by symmetry.
+  T sign = 1;
+  if (i >= steps) {
+    i -= steps;
+    sign = -1;
+  }
+  if (i <= steps / 2) {
+    s = sign * values[i];
+    c = sign * values[steps / 2 - i];
+  } else {
+    s = sign * values[steps - i];
+    c = -sign * values[i - steps / 2];
+  }
+}
+
+template <EulerOrder O, typename T>
+BasicQuaternion<T> toQuaternion(BasicEulerAngle<T> e, const BasicSinCosTable<T>& table) {
+  T cx, sx, cy, sy, cz, sz;
+  table.halfSinCos(e.x, sx, cx);
+  table.halfSinCos(e.y, sy, cy);
+  table.halfSinCos(e.z, sz, cz);
+  return EulerAngleToQuaternion<O>::convert(cx, sx, cy, sy, cz, sz);
+}
+
+template <typename T>
+BasicQuaternion<T> toQuaternion(BasicEulerAngle<T> e, const BasicSinCosTable<T>& table) {
+  return withEulerOrder(e.order, [&](auto o) {
+    return toQuaternion<decltype(o)::value>(e, table);
+  });
+}
+
+#endif // __SINCOSTABLE_H__
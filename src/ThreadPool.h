@@ -0,0 +1,177 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Each participant owns a deque of tasks; it pops its own tasks from the back and steals
+// from the front of the other deques when its own runs dry. The thread calling parallelFor takes part as well, so a
+// pool of threadCount threads starts threadCount - 1 workers.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  size_t threadCount() const { return workers.size() + 1; }
+  // Calls f(begin, end) for consecutive ranges of at most grain indices covering [0, count) and returns when all of
+  // them are done. The first exception thrown by f is rethrown here.
+  template <typename F>
+  void parallelFor(size_t count, size_t grain, F f);
+
+private:
+  struct Job {
+    std::function<void(size_t)> run;
+    size_t remaining;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  struct Task {
+    Job* job;
+    size_t chunk;
+  };
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> pending;
+  bool stopping;
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  bool take(size_t index, Task& task);
+  void execute(Task task);
+  void work(size_t index);
+};
+
+ThreadPool::ThreadPool(size_t threadCount): pending(0), stopping(false) {
+  if (threadCount == 0) {
+    threadCount = 1;
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    queues.emplace_back(new WorkQueue());
+  }
+  for (size_t i = 1; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+bool ThreadPool::take(size_t index, Task& task) {
+  auto size = queues.size();
+  for (size_t k = 0; k < size; k++) {
+    auto& queue = *queues[(index + k) % size];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (k == 0) {
+      task = queue.tasks.back();
+      queue.tasks.pop_back();
+    } else {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+    }
+    pending--;
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::execute(Task task) {
+  auto job = task.job;
+  std::exception_ptr error;
+  try {
+    job->run(task.chunk);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // The job lives on the caller's stack, so it must not be touched after the lock is released for the last chunk.
+  std::lock_guard<std::mutex> lock(job->mutex);
+  if (error && !job->error) {
+    job->error = error;
+  }
+  if (--job->remaining == 0) {
+    job->done.notify_all();
+  }
+}
+
+void ThreadPool::work(size_t index) {
+  while (true) {
+    Task task;
+    if (take(index, task)) {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || pending > 0; });
+    if (stopping && pending == 0) {
+      return;
+    }
+  }
+}
+
+template <typename F>
+void ThreadPool::parallelFor(size_t count, size_t grain, F f) {
+  if (grain == 0) {
+    grain = 1;
+  }
+  auto chunks = (count + grain - 1) / grain;
+  if (chunks <= 1 || workers.empty()) {
+    for (size_t begin = 0; begin < count; begin += grain) {
+      f(begin, count - begin < grain ? count : begin + grain);
+    }
+    return;
+  }
+  Job job;
+  job.run = [&](size_t chunk) {
+    auto begin = chunk * grain;
+    f(begin, count - begin < grain ? count : begin + grain);
+  };
+  job.remaining = chunks;
+  pending += chunks;
+  // Each queue gets a contiguous block of chunks, lowest chunk at the back so its owner walks the block forward.
+  auto size = queues.size();
+  for (size_t i = 0; i < size; i++) {
+    auto& queue = *queues[i];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (auto chunk = (i + 1) * chunks / size; chunk > i * chunks / size; chunk--) {
+      queue.tasks.push_back(Task{ &job, chunk - 1 });
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+  }
+  wake.notify_all();
+  Task task;
+  while (take(0, task)) {
+    execute(task);
+  }
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.done.wait(lock, [&] { return job.remaining == 0; });
+  if (job.error) {
+    std::rethrow_exception(job.error);
+  }
+}
+
+#endif // __THREADPOOL_H__
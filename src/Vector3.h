@@ -1,12 +1,16 @@
 #ifndef __VECTOR3_H__
 #define __VECTOR3_H__
 
-class Vector3 {
+template <typename T>
+class BasicVector3 {
 public:
-  float x;
-  float y;
-  float z;
-  Vector3(float x, float y, float z): x(x), y(y), z(z) {}
+  T x;
+  T y;
+  T z;
+  BasicVector3(T x, T y, T z): x(x), y(y), z(z) {}
 };
 
+using Vector3 = BasicVector3<float>;
+using Vector3d = BasicVector3<double>;
+
 #endif // __VECTOR3_H__
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef __BATCHCONVERSION_H__
+#define __BATCHCONVERSION_H__
+
+#include <cstddef>
+
+#include "./EulerAngle.h"
+#include "./Half.h"
+#include "./conversion.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./batchConversionKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// Converts count quaternions stored as separate x/y/z/w arrays into euler angles stored as separate x/y/z arrays.
+// Angles stay within 5e-5 rad of toEulerAngle(Quaternion, EulerOrder) for unit quaternions (typically 5e-7 rad);
+// near gimbal lock compare the resulting rotations instead, since lanes may pick the other branch.
+void toEulerAngleBatch(const float* x, const float* y, const float* z, const float* w, size_t count, EulerOrder order,
+    float* ex, float* ey, float* ez) {
+  SIMD_DISPATCH(toEulerAngleBatch, x, y, z, w, count, order, ex, ey, ez);
+}
+
+// Converts count rotation matrices, stored back to back as RotationMatrix::elements, into quaternions stored as
+// separate x/y/z/w arrays. The largest-component selection of toQuaternion(RotationMatrix) is done with lane masks.
+void toQuaternionBatch(const float* elements, size_t count, float* x, float* y, float* z, float* w) {
+  SIMD_DISPATCH(toQuaternionBatch, elements, count, x, y, z, w);
+}
+
+// Converts count euler angles stored as separate x/y/z arrays into rotation matrices written back to back as
+// RotationMatrix::elements. Sine and cosine of each angle come from one shared polynomial kernel.
+void toRotationMatrixBatch(const float* x, const float* y, const float* z, size_t count, EulerOrder order, float* elements) {
+  SIMD_DISPATCH(toRotationMatrixBatch, x, y, z, count, order, elements);
+}
+
+// Noexcept forms of the three conversions above for code that must neither throw nor touch lazily initialized state,
+// such as the element functions of parallel algorithms: the SIMD tier is passed in, read from simd::tier()
+// beforehand, and an invalid order is returned as an error with nothing written.
+ConversionError tryToEulerAngleBatch(simd::Tier tier, const float* x, const float* y, const float* z, const float* w,
+    size_t count, EulerOrder order, float* ex, float* ey, float* ez) noexcept {
+  if (!isValidEulerOrder(order)) {
+    return ConversionError::InvalidEulerOrder;
+  }
+  [&] { SIMD_DISPATCH_TIER(tier, toEulerAngleBatch, x, y, z, w, count, order, ex, ey, ez); }();
+  return ConversionError::None;
+}
+
+void toQuaternionBatch(simd::Tier tier, const float* elements, size_t count, float* x, float* y, float* z,
+    float* w) noexcept {
+  SIMD_DISPATCH_TIER(tier, toQuaternionBatch, elements, count, x, y, z, w);
+}
+
+ConversionError tryToRotationMatrixBatch(simd::Tier tier, const float* x, const float* y, const float* z, size_t count,
+    EulerOrder order, float* elements) noexcept {
+  if (!isValidEulerOrder(order)) {
+    return ConversionError::InvalidEulerOrder;
+  }
+  [&] { SIMD_DISPATCH_TIER(tier, toRotationMatrixBatch, x, y, z, count, order, elements); }();
+  return ConversionError::None;
+}
+
+// Widens count half-precision values into floats; F16C is used on the AVX2 and AVX-512 tiers.
+void widenBatch(const Half* values, size_t count, float* result) {
+  SIMD_DISPATCH(widenHalfBatch, reinterpret_cast<const uint16_t*>(values), count, result);
+}
+
+// Narrows count floats into half-precision values with round-to-nearest-even.
+void narrowBatch(const float* values, size_t count, Half* result) {
+  SIMD_DISPATCH(narrowHalfBatch, values, count, reinterpret_cast<uint16_t*>(result));
+}
+
+void widenBatch(const BFloat16* values, size_t count, float* result) {
+  for (size_t i = 0; i < count; i++) {
+    result[i] = bFloat16BitsToFloat(values[i].bits);
+  }
+}
+
+void narrowBatch(const float* values, size_t count, BFloat16* result) {
+  for (size_t i = 0; i < count; i++) {
+    result[i] = BFloat16(values[i]);
+  }
+}
+
+// Reduced-precision storage overloads. Values are widened to float chunk by chunk, converted with the float batch
+// functions above and narrowed back, so H is Half or BFloat16 and all arithmetic stays in float.
+const size_t HALF_BATCH_CHUNK = 256;
+
+template <typename H>
+void toEulerAngleBatch(const H* x, const H* y, const H* z, const H* w, size_t count, EulerOrder order,
+    H* ex, H* ey, H* ez) {
+  float fx[HALF_BATCH_CHUNK], fy[HALF_BATCH_CHUNK], fz[HALF_BATCH_CHUNK], fw[HALF_BATCH_CHUNK];
+  for (size_t i = 0; i < count; i += HALF_BATCH_CHUNK) {
+    auto n = count - i < HALF_BATCH_CHUNK ? count - i : HALF_BATCH_CHUNK;
+    widenBatch(x + i, n, fx);
+    widenBatch(y + i, n, fy);
+    widenBatch(z + i, n, fz);
+    widenBatch(w + i, n, fw);
+    toEulerAngleBatch(fx, fy, fz, fw, n, order, fx, fy, fz);
+    narrowBatch(fx, n, ex + i);
+    narrowBatch(fy, n, ey + i);
+    narrowBatch(fz, n, ez + i);
+  }
+}
+
+template <typename H>
+void toQuaternionBatch(const H* elements, size_t count, H* x, H* y, H* z, H* w) {
+  float fe[9 * HALF_BATCH_CHUNK];
+  float fx[HALF_BATCH_CHUNK], fy[HALF_BATCH_CHUNK], fz[HALF_BATCH_CHUNK], fw[HALF_BATCH_CHUNK];
+  for (size_t i = 0; i < count; i += HALF_BATCH_CHUNK) {
+    auto n = count - i < HALF_BATCH_CHUNK ? count - i : HALF_BATCH_CHUNK;
+    widenBatch(elements + 9 * i, 9 * n, fe);
+    toQuaternionBatch(fe, n, fx, fy, fz, fw);
+    narrowBatch(fx, n, x + i);
+    narrowBatch(fy, n, y + i);
+    narrowBatch(fz, n, z + i);
+    narrowBatch(fw, n, w + i);
+  }
+}
+
+template <typename H>
+void toRotationMatrixBatch(const H* x, const H* y, const H* z, size_t count, EulerOrder order, H* elements) {
+  float fx[HALF_BATCH_CHUNK], fy[HALF_BATCH_CHUNK], fz[HALF_BATCH_CHUNK];
+  float fe[9 * HALF_BATCH_CHUNK];
+  for (size_t i = 0; i < count; i += HALF_BATCH_CHUNK) {
+    auto n = count - i < HALF_BATCH_CHUNK ? count - i : HALF_BATCH_CHUNK;
+    widenBatch(x + i, n, fx);
+    widenBatch(y + i, n, fy);
+    widenBatch(z + i, n, fz);
+    toRotationMatrixBatch(fx, fy, fz, n, order, fe);
+    narrowBatch(fe, 9 * n, elements + 9 * i);
+  }
+}
+
+#endif // __BATCHCONVERSION_H__
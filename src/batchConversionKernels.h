@@ -0,0 +1,250 @@
+// Lane-generic kernels behind batchConversion.h, included once per SIMD target through simdTargets.h.
+
+template <class V>
+void toEulerAngleLanes(const V x, const V y, const V z, const V w, EulerOrder order, V& ex, V& ey, V& ez) {
+  auto xx2 = V(2) * x * x;
+  auto yy2 = V(2) * y * y;
+  auto zz2 = V(2) * z * z;
+  auto ww2 = V(2) * w * w;
+  auto xy2 = V(2) * x * y;
+  auto xz2 = V(2) * x * z;
+  auto xw2 = V(2) * x * w;
+  auto yz2 = V(2) * y * z;
+  auto yw2 = V(2) * y * w;
+  auto zw2 = V(2) * z * w;
+  auto one = V(1);
+  auto zero = V(0);
+  auto threshold = V(GIMBAL_LOCK_SINE);
+  if (order == EulerOrder::XYZ) {
+    auto sy = xz2 + yw2;
+    auto unlocked = simd::abs(sy) < threshold;
+    ex = atan2(simd::select(unlocked, -(yz2 - xw2), yz2 + xw2), simd::select(unlocked, ww2 + zz2 - one, ww2 + yy2 - one));
+    ey = asin(sy);
+    ez = simd::select(unlocked, atan2(-(xy2 - zw2), ww2 + xx2 - one), zero);
+  } else if (order == EulerOrder::XZY) {
+    auto sz = -(xy2 - zw2);
+    auto unlocked = simd::abs(sz) < threshold;
+    ex = atan2(simd::select(unlocked, yz2 + xw2, -(yz2 - xw2)), simd::select(unlocked, ww2 + yy2 - one, ww2 + zz2 - one));
+    ey = simd::select(unlocked, atan2(xz2 + yw2, ww2 + xx2 - one), zero);
+    ez = asin(sz);
+  } else if (order == EulerOrder::YXZ) {
+    auto sx = -(yz2 - xw2);
+    auto unlocked = simd::abs(sx) < threshold;
+    ex = asin(sx);
+    ey = atan2(simd::select(unlocked, xz2 + yw2, -(xz2 - yw2)), simd::select(unlocked, ww2 + zz2 - one, ww2 + xx2 - one));
+    ez = simd::select(unlocked, atan2(xy2 + zw2, ww2 + yy2 - one), zero);
+  } else if (order == EulerOrder::YZX) {
+    auto sz = xy2 + zw2;
+    auto unlocked = simd::abs(sz) < threshold;
+    ex = simd::select(unlocked, atan2(-(yz2 - xw2), ww2 + yy2 - one), zero);
+    ey = atan2(simd::select(unlocked, -(xz2 - yw2), xz2 + yw2), simd::select(unlocked, ww2 + xx2 - one, ww2 + zz2 - one));
+    ez = asin(sz);
+  } else if (order == EulerOrder::ZXY) {
+    auto sx = yz2 + xw2;
+    auto unlocked = simd::abs(sx) < threshold;
+    ex = asin(sx);
+    ey = simd::select(unlocked, atan2(-(xz2 - yw2), ww2 + zz2 - one), zero);
+    ez = atan2(simd::select(unlocked, -(xy2 - zw2), xy2 + zw2), simd::select(unlocked, ww2 + yy2 - one, ww2 + xx2 - one));
+  } else if (order == EulerOrder::ZYX) {
+    auto sy = -(xz2 - yw2);
+    auto unlocked = simd::abs(sy) < threshold;
+    ex = simd::select(unlocked, atan2(yz2 + xw2, ww2 + zz2 - one), zero);
+    ey = asin(sy);
+    ez = atan2(simd::select(unlocked, xy2 + zw2, -(xy2 - zw2)), simd::select(unlocked, ww2 + xx2 - one, ww2 + yy2 - one));
+  } else {
+    throw "conversion of quaternion to euler angle is failed.";
+  }
+}
+
+template <class V>
+void toEulerAngleBatch(const float* x, const float* y, const float* z, const float* w, size_t count, EulerOrder order,
+    float* ex, float* ey, float* ez) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V rx, ry, rz;
+    toEulerAngleLanes(V::load(x + i), V::load(y + i), V::load(z + i), V::load(w + i), order, rx, ry, rz);
+    rx.store(ex + i);
+    ry.store(ey + i);
+    rz.store(ez + i);
+  }
+  if (i < count) {
+    float tx[V::width] = {}, ty[V::width] = {}, tz[V::width] = {}, tw[V::width] = {};
+    float rx[V::width], ry[V::width], rz[V::width];
+    auto rest = count - i;
+    for (size_t j = 0; j < V::width; j++) {
+      tw[j] = 1;
+    }
+    for (size_t j = 0; j < rest; j++) {
+      tx[j] = x[i + j];
+      ty[j] = y[i + j];
+      tz[j] = z[i + j];
+      tw[j] = w[i + j];
+    }
+    toEulerAngleBatch<V>(tx, ty, tz, tw, V::width, order, rx, ry, rz);
+    for (size_t j = 0; j < rest; j++) {
+      ex[i + j] = rx[j];
+      ey[i + j] = ry[j];
+      ez[i + j] = rz[j];
+    }
+  }
+}
+
+template <class V>
+void toQuaternionLanes(const float* elements, V& x, V& y, V& z, V& w) {
+  auto m00 = V::loadStrided(elements + 0, 9);
+  auto m10 = V::loadStrided(elements + 1, 9);
+  auto m20 = V::loadStrided(elements + 2, 9);
+  auto m01 = V::loadStrided(elements + 3, 9);
+  auto m11 = V::loadStrided(elements + 4, 9);
+  auto m21 = V::loadStrided(elements + 5, 9);
+  auto m02 = V::loadStrided(elements + 6, 9);
+  auto m12 = V::loadStrided(elements + 7, 9);
+  auto m22 = V::loadStrided(elements + 8, 9);
+
+  auto px = m00 - m11 - m22 + V(1);
+  auto py = -m00 + m11 - m22 + V(1);
+  auto pz = -m00 - m11 + m22 + V(1);
+  auto pw = m00 + m11 + m22 + V(1);
+
+  auto max = px;
+  auto selectedY = max < py;
+  max = simd::select(selectedY, py, max);
+  auto selectedZ = max < pz;
+  max = simd::select(selectedZ, pz, max);
+  auto selectedW = max < pw;
+  max = simd::select(selectedW, pw, max);
+
+  auto largest = simd::sqrt(max) * V(0.5f);
+  auto d = V(1) / (V(4) * largest);
+  auto xy = (m10 + m01) * d;
+  auto xz = (m02 + m20) * d;
+  auto yz = (m21 + m12) * d;
+  auto xw = (m21 - m12) * d;
+  auto yw = (m02 - m20) * d;
+  auto zw = (m10 - m01) * d;
+  x = simd::select(selectedW, xw, simd::select(selectedZ, xz, simd::select(selectedY, xy, largest)));
+  y = simd::select(selectedW, yw, simd::select(selectedZ, yz, simd::select(selectedY, largest, xy)));
+  z = simd::select(selectedW, zw, simd::select(selectedZ, largest, simd::select(selectedY, yz, xz)));
+  w = simd::select(selectedW, largest, simd::select(selectedZ, zw, simd::select(selectedY, yw, xw)));
+}
+
+template <class V>
+void toQuaternionBatch(const float* elements, size_t count, float* x, float* y, float* z, float* w) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V rx, ry, rz, rw;
+    toQuaternionLanes(elements + 9 * i, rx, ry, rz, rw);
+    rx.store(x + i);
+    ry.store(y + i);
+    rz.store(z + i);
+    rw.store(w + i);
+  }
+  if (i < count) {
+    float te[9 * V::width] = {};
+    float rx[V::width], ry[V::width], rz[V::width], rw[V::width];
+    auto rest = count - i;
+    for (size_t j = 0; j < V::width; j++) {
+      te[9 * j] = te[9 * j + 4] = te[9 * j + 8] = 1;
+    }
+    for (size_t j = 0; j < 9 * rest; j++) {
+      te[j] = elements[9 * i + j];
+    }
+    toQuaternionBatch<V>(te, V::width, rx, ry, rz, rw);
+    for (size_t j = 0; j < rest; j++) {
+      x[i + j] = rx[j];
+      y[i + j] = ry[j];
+      z[i + j] = rz[j];
+      w[i + j] = rw[j];
+    }
+  }
+}
+
+template <class V>
+void toRotationMatrixLanes(const V x, const V y, const V z, EulerOrder order, float* elements) {
+  V sx, cx, sy, cy, sz, cz;
+  sincos(x, sx, cx);
+  sincos(y, sy, cy);
+  sincos(z, sz, cz);
+  V m[9];
+  switch (order) {
+  case EulerOrder::XYZ:
+    m[0] = cy * cz; m[1] = sx * sy * cz + cx * sz; m[2] = -cx * sy * cz + sx * sz;
+    m[3] = -cy * sz; m[4] = -sx * sy * sz + cx * cz; m[5] = cx * sy * sz + sx * cz;
+    m[6] = sy; m[7] = -sx * cy; m[8] = cx * cy;
+    break;
+  case EulerOrder::XZY:
+    m[0] = cy * cz; m[1] = cx * cy * sz + sx * sy; m[2] = sx * cy * sz - cx * sy;
+    m[3] = -sz; m[4] = cx * cz; m[5] = sx * cz;
+    m[6] = sy * cz; m[7] = cx * sy * sz - sx * cy; m[8] = sx * sy * sz + cx * cy;
+    break;
+  case EulerOrder::YXZ:
+    m[0] = sx * sy * sz + cy * cz; m[1] = cx * sz; m[2] = sx * cy * sz - sy * cz;
+    m[3] = sx * sy * cz - cy * sz; m[4] = cx * cz; m[5] = sx * cy * cz + sy * sz;
+    m[6] = cx * sy; m[7] = -sx; m[8] = cx * cy;
+    break;
+  case EulerOrder::YZX:
+    m[0] = cy * cz; m[1] = sz; m[2] = -sy * cz;
+    m[3] = -cx * cy * sz + sx * sy; m[4] = cx * cz; m[5] = cx * sy * sz + sx * cy;
+    m[6] = sx * cy * sz + cx * sy; m[7] = -sx * cz; m[8] = -sx * sy * sz + cx * cy;
+    break;
+  case EulerOrder::ZXY:
+    m[0] = -sx * sy * sz + cy * cz; m[1] = sx * sy * cz + cy * sz; m[2] = -cx * sy;
+    m[3] = -cx * sz; m[4] = cx * cz; m[5] = sx;
+    m[6] = sx * cy * sz + sy * cz; m[7] = -sx * cy * cz + sy * sz; m[8] = cx * cy;
+    break;
+  case EulerOrder::ZYX:
+    m[0] = cy * cz; m[1] = cy * sz; m[2] = -sy;
+    m[3] = sx * sy * cz - cx * sz; m[4] = sx * sy * sz + cx * cz; m[5] = sx * cy;
+    m[6] = cx * sy * cz + sx * sz; m[7] = cx * sy * sz - sx * cz; m[8] = cx * cy;
+    break;
+  default:
+    throw "conversion of euler angle to rotation matrix is failed.";
+  }
+  for (size_t i = 0; i < 9; i++) {
+    m[i].storeStrided(elements + i, 9);
+  }
+}
+
+template <class V>
+void toRotationMatrixBatch(const float* x, const float* y, const float* z, size_t count, EulerOrder order, float* elements) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    toRotationMatrixLanes(V::load(x + i), V::load(y + i), V::load(z + i), order, elements + 9 * i);
+  }
+  if (i < count) {
+    float tx[V::width] = {}, ty[V::width] = {}, tz[V::width] = {};
+    float te[9 * V::width];
+    auto rest = count - i;
+    for (size_t j = 0; j < rest; j++) {
+      tx[j] = x[i + j];
+      ty[j] = y[i + j];
+      tz[j] = z[i + j];
+    }
+    toRotationMatrixBatch<V>(tx, ty, tz, V::width, order, te);
+    for (size_t j = 0; j < 9 * rest; j++) {
+      elements[9 * i + j] = te[j];
+    }
+  }
+}
+
+template <class V>
+void widenHalfBatch(const uint16_t* bits, size_t count, float* values) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V::loadHalf(bits + i).store(values + i);
+  }
+  for (; i < count; i++) {
+    values[i] = halfBitsToFloat(bits[i]);
+  }
+}
+
+template <class V>
+void narrowHalfBatch(const float* values, size_t count, uint16_t* bits) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V::load(values + i).storeHalf(bits + i);
+  }
+  for (; i < count; i++) {
+    bits[i] = floatToHalfBits(values[i]);
+  }
+}
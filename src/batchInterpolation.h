@@ -0,0 +1,98 @@
+#ifndef __BATCHINTERPOLATION_H__
+#define __BATCHINTERPOLATION_H__
+
+#include <algorithm>
+#include <cstddef>
+
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./interpolationKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+enum class Interpolation {
+  Slerp,
+  Nlerp
+};
+
+// Interpolates count quaternion pairs stored as separate x/y/z/w arrays, each at its own t, with slerp or nlerp of
+// Quaternion.h; results stay within 2e-6 of the scalar functions. The outputs may alias the inputs.
+void interpolateBatch(Interpolation mode, const float* ax, const float* ay, const float* az, const float* aw,
+    const float* bx, const float* by, const float* bz, const float* bw, const float* t, size_t count,
+    float* x, float* y, float* z, float* w) {
+  SIMD_DISPATCH(interpolateBatch, ax, ay, az, aw, bx, by, bz, bw, t, count, mode == Interpolation::Slerp,
+    x, y, z, w, nullptr);
+}
+
+// Same, with the results written as rotation matrices back to back as RotationMatrix::elements.
+void interpolateBatch(Interpolation mode, const float* ax, const float* ay, const float* az, const float* aw,
+    const float* bx, const float* by, const float* bz, const float* bw, const float* t, size_t count, float* elements) {
+  SIMD_DISPATCH(interpolateBatch, ax, ay, az, aw, bx, by, bz, bw, t, count, mode == Interpolation::Slerp,
+    nullptr, nullptr, nullptr, nullptr, elements);
+}
+
+// Keyframed rotation track viewing caller-owned arrays of count key times, strictly increasing, and key rotations.
+// Sampling clamps to the first and last key outside of the keyed time range.
+class QuaternionTrack {
+public:
+  const float* times;
+  const Quaternion* keys;
+  size_t count;
+};
+
+const size_t SAMPLE_CHUNK = 256;
+
+// Samples every track at time: the bracketing keys of each track are found by binary search and gathered into SoA
+// buffers, SAMPLE_CHUNK tracks at a time, which are interpolated in one SIMD pass. Writes quaternions to x/y/z/w, or
+// rotation matrices to elements when it is not null.
+void sampleTracks(const QuaternionTrack* tracks, size_t count, float time, Interpolation mode,
+    float* x, float* y, float* z, float* w, float* elements) {
+  float ax[SAMPLE_CHUNK], ay[SAMPLE_CHUNK], az[SAMPLE_CHUNK], aw[SAMPLE_CHUNK];
+  float bx[SAMPLE_CHUNK], by[SAMPLE_CHUNK], bz[SAMPLE_CHUNK], bw[SAMPLE_CHUNK];
+  float t[SAMPLE_CHUNK];
+  for (size_t begin = 0; begin < count; begin += SAMPLE_CHUNK) {
+    auto n = std::min(SAMPLE_CHUNK, count - begin);
+    for (size_t j = 0; j < n; j++) {
+      const auto& track = tracks[begin + j];
+      if (track.count == 0) {
+        throw "track has no keys.";
+      }
+      auto next = static_cast<size_t>(std::upper_bound(track.times, track.times + track.count, time) - track.times);
+      auto previous = next == 0 ? 0 : next - 1;
+      next = std::min(next, track.count - 1);
+      auto a = track.keys[previous];
+      auto b = track.keys[next];
+      t[j] = next == previous ? 0 : (time - track.times[previous]) / (track.times[next] - track.times[previous]);
+      ax[j] = a.x;
+      ay[j] = a.y;
+      az[j] = a.z;
+      aw[j] = a.w;
+      bx[j] = b.x;
+      by[j] = b.y;
+      bz[j] = b.z;
+      bw[j] = b.w;
+    }
+    if (elements) {
+      interpolateBatch(mode, ax, ay, az, aw, bx, by, bz, bw, t, n, elements + 9 * begin);
+    } else {
+      interpolateBatch(mode, ax, ay, az, aw, bx, by, bz, bw, t, n, x + begin, y + begin, z + begin, w + begin);
+    }
+  }
+}
+
+void sampleTracks(const QuaternionTrack* tracks, size_t count, float time, Interpolation mode,
+    float* x, float* y, float* z, float* w) {
+  sampleTracks(tracks, count, time, mode, x, y, z, w, nullptr);
+}
+
+void sampleTracks(const QuaternionTrack* tracks, size_t count, float time, Interpolation mode, RotationMatrix* result) {
+  static_assert(sizeof(RotationMatrix) == 9 * sizeof(float), "rotation matrices must be packed.");
+  if (count == 0) {
+    return;
+  }
+  sampleTracks(tracks, count, time, mode, nullptr, nullptr, nullptr, nullptr, result->elements.data());
+}
+
+#endif // __BATCHINTERPOLATION_H__
@@ -0,0 +1,43 @@
+#ifndef __BATCHROTATION_H__
+#define __BATCHROTATION_H__
+
+#include <cstddef>
+
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./conversion.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./batchRotationKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// Rotates the i-th vector by the i-th quaternion, with both stored as separate component arrays.
+// The outputs may alias the vector inputs.
+void rotateBatch(const float* qx, const float* qy, const float* qz, const float* qw,
+    const float* vx, const float* vy, const float* vz, size_t count, float* rx, float* ry, float* rz) {
+  SIMD_DISPATCH(rotateBatch, qx, qy, qz, qw, vx, vy, vz, count, rx, ry, rz);
+}
+
+// Applies one rotation to count points stored as separate x/y/z arrays. The nine matrix coefficients are broadcast
+// once and the outputs may alias the inputs for in-place rotation. A quaternion is converted to a matrix first.
+void rotateBatch(const RotationMatrix m, const float* x, const float* y, const float* z, size_t count,
+    float* rx, float* ry, float* rz) {
+  SIMD_DISPATCH(rotateBatch, m, x, y, z, count, rx, ry, rz);
+}
+
+void rotateBatch(const Quaternion q, const float* x, const float* y, const float* z, size_t count,
+    float* rx, float* ry, float* rz) {
+  SIMD_DISPATCH(rotateBatch, toRotationMatrix(q), x, y, z, count, rx, ry, rz);
+}
+
+// Same as rotateBatch for points stored as packed xyz triples; result may be xyz itself.
+void rotateInterleavedBatch(const RotationMatrix m, const float* xyz, size_t count, float* result) {
+  SIMD_DISPATCH(rotateInterleavedBatch, m, xyz, count, result);
+}
+
+void rotateInterleavedBatch(const Quaternion q, const float* xyz, size_t count, float* result) {
+  SIMD_DISPATCH(rotateInterleavedBatch, toRotationMatrix(q), xyz, count, result);
+}
+
+#endif // __BATCHROTATION_H__
@@ -0,0 +1,89 @@
+// Lane-generic kernels behind batchRotation.h, included once per SIMD target through simdTargets.h.
+
+template <class V>
+void rotateLanes(const V qx, const V qy, const V qz, const V qw, const V vx, const V vy, const V vz, V& rx, V& ry, V& rz) {
+  auto tx = V(2) * (qy * vz - qz * vy);
+  auto ty = V(2) * (qz * vx - qx * vz);
+  auto tz = V(2) * (qx * vy - qy * vx);
+  rx = vx + qw * tx + qy * tz - qz * ty;
+  ry = vy + qw * ty + qz * tx - qx * tz;
+  rz = vz + qw * tz + qx * ty - qy * tx;
+}
+
+template <class V>
+void rotateBatch(const float* qx, const float* qy, const float* qz, const float* qw,
+    const float* vx, const float* vy, const float* vz, size_t count, float* rx, float* ry, float* rz) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V x, y, z;
+    rotateLanes(V::load(qx + i), V::load(qy + i), V::load(qz + i), V::load(qw + i),
+      V::load(vx + i), V::load(vy + i), V::load(vz + i), x, y, z);
+    x.store(rx + i);
+    y.store(ry + i);
+    z.store(rz + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 x, y, z;
+    rotateLanes<simd::Float1>(qx[i], qy[i], qz[i], qw[i], vx[i], vy[i], vz[i], x, y, z);
+    rx[i] = x.v;
+    ry[i] = y.v;
+    rz[i] = z.v;
+  }
+}
+
+template <class V>
+void rotateLanes(const V* m, const V vx, const V vy, const V vz, V& rx, V& ry, V& rz) {
+  rx = simd::fma(m[0], vx, simd::fma(m[3], vy, m[6] * vz));
+  ry = simd::fma(m[1], vx, simd::fma(m[4], vy, m[7] * vz));
+  rz = simd::fma(m[2], vx, simd::fma(m[5], vy, m[8] * vz));
+}
+
+template <class V>
+void rotateBatch(const RotationMatrix m, const float* x, const float* y, const float* z, size_t count,
+    float* rx, float* ry, float* rz) {
+  V coefficients[9];
+  simd::Float1 scalarCoefficients[9];
+  for (size_t j = 0; j < 9; j++) {
+    coefficients[j] = V(m.elements[j]);
+    scalarCoefficients[j] = simd::Float1(m.elements[j]);
+  }
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V vx, vy, vz;
+    rotateLanes(coefficients, V::load(x + i), V::load(y + i), V::load(z + i), vx, vy, vz);
+    vx.store(rx + i);
+    vy.store(ry + i);
+    vz.store(rz + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 vx, vy, vz;
+    rotateLanes<simd::Float1>(scalarCoefficients, x[i], y[i], z[i], vx, vy, vz);
+    rx[i] = vx.v;
+    ry[i] = vy.v;
+    rz[i] = vz.v;
+  }
+}
+
+template <class V>
+void rotateInterleavedBatch(const RotationMatrix m, const float* xyz, size_t count, float* result) {
+  V coefficients[9];
+  simd::Float1 scalarCoefficients[9];
+  for (size_t j = 0; j < 9; j++) {
+    coefficients[j] = V(m.elements[j]);
+    scalarCoefficients[j] = simd::Float1(m.elements[j]);
+  }
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V x, y, z, vx, vy, vz;
+    V::loadInterleaved3(xyz + 3 * i, x, y, z);
+    rotateLanes(coefficients, x, y, z, vx, vy, vz);
+    V::storeInterleaved3(result + 3 * i, vx, vy, vz);
+  }
+  for (; i < count; i++) {
+    simd::Float1 vx, vy, vz;
+    rotateLanes<simd::Float1>(scalarCoefficients, xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2], vx, vy, vz);
+    result[3 * i] = vx.v;
+    result[3 * i + 1] = vy.v;
+    result[3 * i + 2] = vz.v;
+  }
+}
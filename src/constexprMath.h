@@ -0,0 +1,189 @@
+#ifndef __CONSTEXPRMATH_H__
+#define __CONSTEXPRMATH_H__
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// Math functions usable in constant expressions. At run time they call the <cmath> functions, so results there are
+// unchanged; during constant evaluation they use the series below, evaluated in double and accurate to a few ulp of
+// double for the argument ranges seen in rotation conversions (|angle| < 1e6).
+namespace constexprMath {
+
+constexpr double PI = 3.14159265358979323846;
+// PI / 2 split for Cody-Waite reduction: HALF_PI_HIGH has trailing zero bits so k * HALF_PI_HIGH is exact.
+constexpr double HALF_PI_HIGH = 1.5707963267341256;
+constexpr double HALF_PI_LOW = 6.077100506506192e-11;
+
+constexpr double seriesSqrt(double x) noexcept {
+  if (x < 0 || x != x) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (x == 0 || x == std::numeric_limits<double>::infinity()) {
+    return x;
+  }
+  // Scale into [1, 4) by powers of 4 so that a fixed number of Newton steps converges.
+  double scale = 1;
+  while (x >= 4) {
+    x *= 0.25;
+    scale *= 2;
+  }
+  while (x < 1) {
+    x *= 4;
+    scale *= 0.5;
+  }
+  double r = 0.5 * (x + 1);
+  for (int i = 0; i < 6; i++) {
+    r = 0.5 * (r + x / r);
+  }
+  return r * scale;
+}
+
+// Taylor series on the reduced range [-PI/4, PI/4].
+constexpr double reducedSin(double x) noexcept {
+  double x2 = x * x;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x2 / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double reducedCos(double x) noexcept {
+  double x2 = x * x;
+  double term = 1;
+  double sum = 1;
+  for (int n = 1; n < 12; n++) {
+    term *= -x2 / ((2 * n - 1) * (2 * n));
+    sum += term;
+  }
+  return sum;
+}
+
+// Reduces x to r in [-PI/4, PI/4] with x = r + quadrant * PI/2.
+constexpr double reduceQuadrant(double x, long long& quadrant) noexcept {
+  double k = x * (2 / PI);
+  quadrant = static_cast<long long>(k < 0 ? k - 0.5 : k + 0.5);
+  return (x - quadrant * HALF_PI_HIGH) - quadrant * HALF_PI_LOW;
+}
+
+constexpr double seriesSin(double x) noexcept {
+  long long quadrant = 0;
+  auto r = reduceQuadrant(x, quadrant);
+  switch (quadrant & 3) {
+  case 0:
+    return reducedSin(r);
+  case 1:
+    return reducedCos(r);
+  case 2:
+    return -reducedSin(r);
+  default:
+    return -reducedCos(r);
+  }
+}
+
+constexpr double seriesCos(double x) noexcept {
+  long long quadrant = 0;
+  auto r = reduceQuadrant(x, quadrant);
+  switch (quadrant & 3) {
+  case 0:
+    return reducedCos(r);
+  case 1:
+    return -reducedSin(r);
+  case 2:
+    return -reducedCos(r);
+  default:
+    return reducedSin(r);
+  }
+}
+
+constexpr double seriesAtan(double x) noexcept {
+  if (x < 0) {
+    return -seriesAtan(-x);
+  }
+  if (x > 1) {
+    return 0.5 * PI - seriesAtan(1 / x);
+  }
+  // Two half-angle steps bring x below tan(PI/16) where the series converges quickly.
+  x = x / (1 + seriesSqrt(1 + x * x));
+  x = x / (1 + seriesSqrt(1 + x * x));
+  double x2 = x * x;
+  double power = x;
+  double sum = x;
+  for (int n = 1; n < 20; n++) {
+    power *= -x2;
+    sum += power / (2 * n + 1);
+  }
+  return 4 * sum;
+}
+
+constexpr double seriesAtan2(double y, double x) noexcept {
+  if (x > 0) {
+    return seriesAtan(y / x);
+  }
+  if (x < 0) {
+    return y < 0 ? seriesAtan(y / x) - PI : seriesAtan(y / x) + PI;
+  }
+  if (y == 0) {
+    return 0;
+  }
+  return y < 0 ? -0.5 * PI : 0.5 * PI;
+}
+
+constexpr double seriesAsin(double x) noexcept {
+  if (x < -1 || x > 1) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return seriesAtan2(x, seriesSqrt(1 - x * x));
+}
+
+template <typename T>
+constexpr T abs(T x) noexcept {
+  return x < 0 ? -x : x;
+}
+
+template <typename T>
+constexpr T sqrt(T x) noexcept {
+  if (std::is_constant_evaluated()) {
+    return static_cast<T>(seriesSqrt(x));
+  }
+  return std::sqrt(x);
+}
+
+template <typename T>
+constexpr T sin(T x) noexcept {
+  if (std::is_constant_evaluated()) {
+    return static_cast<T>(seriesSin(x));
+  }
+  return std::sin(x);
+}
+
+template <typename T>
+constexpr T cos(T x) noexcept {
+  if (std::is_constant_evaluated()) {
+    return static_cast<T>(seriesCos(x));
+  }
+  return std::cos(x);
+}
+
+template <typename T>
+constexpr T atan2(T y, T x) noexcept {
+  if (std::is_constant_evaluated()) {
+    return static_cast<T>(seriesAtan2(y, x));
+  }
+  return std::atan2(y, x);
+}
+
+template <typename T>
+constexpr T asin(T x) noexcept {
+  if (std::is_constant_evaluated()) {
+    return static_cast<T>(seriesAsin(x));
+  }
+  return std::asin(x);
+}
+
+} // namespace constexprMath
+
+#endif // __CONSTEXPRMATH_H__
@@ -2,311 +2,743 @@
 #define __ROTATIONUTILS_H__
 
 #include <cmath>
+#include <type_traits>
 
 #include "./EulerAngle.h"
 #include "./Quaternion.h"
 #include "./RotationMatrix.h"
+#include "./constexprMath.h"
+#include "./simd.h"
 
-EulerAngle toEulerAngle(Quaternion q, EulerOrder order) {
-  if (order == EulerOrder::XYZ) {
-    auto sy = 2 * q.x * q.z + 2 * q.y * q.w;
-    auto unlocked = std::abs(sy) < 0.99999f;
-    return EulerAngle(
-      unlocked ? std::atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1)
-        : std::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1),
-      std::asin(sy),
-      unlocked ? std::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1) : 0,
-      order
+enum class TrigPrecision {
+  Exact,
+  Fast,
+  Fastest
+};
+
+template <TrigPrecision P, typename T>
+void approximateSinCos(T angle, T& s, T& c) noexcept {
+  simd::Float1 vs, vc;
+  if (P == TrigPrecision::Fast) {
+    simd::scalar::sincos(simd::Float1(static_cast<float>(angle)), vs, vc);
+  } else {
+    simd::scalar::sincosFastest(simd::Float1(static_cast<float>(angle)), vs, vc);
+  }
+  s = vs.v;
+  c = vc.v;
+}
+
+// Exact uses libm, Fast is within 2e-7 of it and Fastest within 1.5e-5, for |angle| < 8192.
+// Fast and Fastest evaluate in float precision for every T. During constant evaluation every precision is exact.
+template <TrigPrecision P, typename T>
+constexpr void sinCos(T angle, T& s, T& c) noexcept {
+  if (P == TrigPrecision::Exact || std::is_constant_evaluated()) {
+    s = constexprMath::sin(angle);
+    c = constexprMath::cos(angle);
+  } else {
+    approximateSinCos<P>(angle, s, c);
+  }
+}
+
+// Result of the noexcept tryTo* conversions, which leave the output untouched on error. The toEulerAngle,
+// toQuaternion and toRotationMatrix functions taking a runtime order throw on the same errors instead.
+enum class ConversionError {
+  None,
+  InvalidEulerOrder
+};
+
+constexpr bool isValidEulerOrder(EulerOrder order) noexcept {
+  return static_cast<size_t>(order) <= static_cast<size_t>(EulerOrder::ZYX);
+}
+
+// Calls f with the order as a std::integral_constant so the conversion inside can take it as a template argument.
+template <typename F>
+constexpr decltype(auto) withEulerOrder(EulerOrder order, F f) {
+  switch (order) {
+  case EulerOrder::XYZ:
+    return f(std::integral_constant<EulerOrder, EulerOrder::XYZ>());
+  case EulerOrder::XZY:
+    return f(std::integral_constant<EulerOrder, EulerOrder::XZY>());
+  case EulerOrder::YXZ:
+    return f(std::integral_constant<EulerOrder, EulerOrder::YXZ>());
+  case EulerOrder::YZX:
+    return f(std::integral_constant<EulerOrder, EulerOrder::YZX>());
+  case EulerOrder::ZXY:
+    return f(std::integral_constant<EulerOrder, EulerOrder::ZXY>());
+  case EulerOrder::ZYX:
+    return f(std::integral_constant<EulerOrder, EulerOrder::ZYX>());
+  default:
+    throw "euler order is invalid.";
+  }
+}
+
+// Conversions to euler angles treat a rotation as gimbal locked when the sine of the middle angle reaches this; they
+// then return a third angle of 0 and fold the rest of the rotation into the first.
+constexpr float GIMBAL_LOCK_SINE = 0.99999f;
+
+template <EulerOrder O>
+class QuaternionToEulerAngle;
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::XYZ> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return 2 * q.x * q.z + 2 * q.y * q.w;
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sy = middleSine(q);
+    auto unlocked = constexprMath::abs(sy) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1)
+        : constexprMath::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1),
+      constexprMath::asin(sy),
+      unlocked ? constexprMath::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1) : 0,
+      EulerOrder::XYZ
     );
-  } else if (order == EulerOrder::XZY) {
-    auto sz = -(2 * q.x * q.y - 2 * q.z * q.w);
-    auto unlocked = std::abs(sz) < 0.99999f;
-    return EulerAngle(
-      unlocked ? std::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1)
-        : std::atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1),
-      unlocked ? std::atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1) : 0,
-      std::asin(sz),
-      order
+  }
+};
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::XZY> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return -(2 * q.x * q.y - 2 * q.z * q.w);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sz = middleSine(q);
+    auto unlocked = constexprMath::abs(sz) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1)
+        : constexprMath::atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1),
+      unlocked ? constexprMath::atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1) : 0,
+      constexprMath::asin(sz),
+      EulerOrder::XZY
     );
-  } else if (order == EulerOrder::YXZ) {
-    auto sx = -(2 * q.y * q.z - 2 * q.x * q.w);
-    auto unlocked = std::abs(sx) < 0.99999f;
-    return EulerAngle(
-      std::asin(sx),
-      unlocked ? std::atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1)
-        : std::atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1),
-      unlocked ? std::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1) : 0,
-      order
+  }
+};
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::YXZ> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return -(2 * q.y * q.z - 2 * q.x * q.w);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sx = middleSine(q);
+    auto unlocked = constexprMath::abs(sx) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      constexprMath::asin(sx),
+      unlocked ? constexprMath::atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1)
+        : constexprMath::atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1),
+      unlocked ? constexprMath::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.y * q.y - 1) : 0,
+      EulerOrder::YXZ
     );
-  } else if (order == EulerOrder::YZX) {
-    auto sz = 2 * q.x * q.y + 2 * q.z * q.w;
-    auto unlocked = std::abs(sz) < 0.99999f;
-    return EulerAngle(
-      unlocked ? atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1) : 0,
-      unlocked ? atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1)
-        : atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1),
-      std::asin(sz),
-      order
+  }
+};
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::YZX> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return 2 * q.x * q.y + 2 * q.z * q.w;
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sz = middleSine(q);
+    auto unlocked = constexprMath::abs(sz) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(-(2 * q.y * q.z - 2 * q.x * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1) : 0,
+      unlocked ? constexprMath::atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.x * q.x - 1)
+        : constexprMath::atan2(2 * q.x * q.z + 2 * q.y * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1),
+      constexprMath::asin(sz),
+      EulerOrder::YZX
     );
-  } else if (order == EulerOrder::ZXY) {
-    auto sx = 2 * q.y * q.z + 2 * q.x * q.w;
-    auto unlocked = std::abs(sx) < 0.99999f;
-    return EulerAngle(
-      std::asin(sx),
-      unlocked ? std::atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1) : 0,
-      unlocked ? std::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1)
-        : std::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1),
-      order
+  }
+};
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::ZXY> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return 2 * q.y * q.z + 2 * q.x * q.w;
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sx = middleSine(q);
+    auto unlocked = constexprMath::abs(sx) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      constexprMath::asin(sx),
+      unlocked ? constexprMath::atan2(-(2 * q.x * q.z - 2 * q.y * q.w), 2 * q.w * q.w + 2 * q.z * q.z - 1) : 0,
+      unlocked ? constexprMath::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1)
+        : constexprMath::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1),
+      EulerOrder::ZXY
     );
-  } else if (order == EulerOrder::ZYX) {
-    auto sy = -(2 * q.x * q.z - 2 * q.y * q.w);
-    auto unlocked = std::abs(sy) < 0.99999f;
-    return EulerAngle(
-      unlocked ? std::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1) : 0,
-      std::asin(sy),
-      unlocked ? std::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1)
-        : std::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1),
-      order
+  }
+};
+
+template <>
+class QuaternionToEulerAngle<EulerOrder::ZYX> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicQuaternion<T>& q) noexcept {
+    return -(2 * q.x * q.z - 2 * q.y * q.w);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto sy = middleSine(q);
+    auto unlocked = constexprMath::abs(sy) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(2 * q.y * q.z + 2 * q.x * q.w, 2 * q.w * q.w + 2 * q.z * q.z - 1) : 0,
+      constexprMath::asin(sy),
+      unlocked ? constexprMath::atan2(2 * q.x * q.y + 2 * q.z * q.w, 2 * q.w * q.w + 2 * q.x * q.x - 1)
+        : constexprMath::atan2(-(2 * q.x * q.y - 2 * q.z * q.w), 2 * q.w * q.w + 2 * q.y * q.y - 1),
+      EulerOrder::ZYX
     );
   }
-  throw "conversion of quaternion to euler angle is failed.";
+};
+
+template <EulerOrder O, typename T>
+constexpr BasicEulerAngle<T> toEulerAngle(BasicQuaternion<T> q) noexcept {
+  return QuaternionToEulerAngle<O>::convert(q);
 }
 
-EulerAngle toEulerAngle(RotationMatrix m, EulerOrder order) {
-  if (order == EulerOrder::XYZ) {
-    auto sy = m.at(0, 2);
-    auto unlocked = std::abs(sy) < 0.99999f; 
-    return EulerAngle(
-      unlocked ? std::atan2(-m.at(1, 2), m.at(2, 2)) : std::atan2(m.at(2, 1), m.at(1, 1)),
-      std::asin(sy),
-      unlocked ? std::atan2(-m.at(0, 1), m.at(0, 0)) : 0,
-      order
+// Whether toEulerAngle<O>(q) detects gimbal lock, decided on the same value as the conversion.
+template <EulerOrder O, typename T>
+constexpr bool isGimbalLocked(const BasicQuaternion<T>& q) noexcept {
+  return !(constexprMath::abs(QuaternionToEulerAngle<O>::middleSine(q)) < GIMBAL_LOCK_SINE);
+}
+
+template <typename T>
+ConversionError tryToEulerAngle(const BasicQuaternion<T>& q, EulerOrder order, BasicEulerAngle<T>& result) noexcept {
+  using Conversion = BasicEulerAngle<T> (*)(BasicQuaternion<T>);
+  static constexpr Conversion conversions[] = {
+    toEulerAngle<EulerOrder::XYZ, T>,
+    toEulerAngle<EulerOrder::XZY, T>,
+    toEulerAngle<EulerOrder::YXZ, T>,
+    toEulerAngle<EulerOrder::YZX, T>,
+    toEulerAngle<EulerOrder::ZXY, T>,
+    toEulerAngle<EulerOrder::ZYX, T>
+  };
+  auto index = static_cast<size_t>(order);
+  if (index >= sizeof(conversions) / sizeof(conversions[0])) {
+    return ConversionError::InvalidEulerOrder;
+  }
+  result = conversions[index](q);
+  return ConversionError::None;
+}
+
+template <typename T>
+BasicEulerAngle<T> toEulerAngle(BasicQuaternion<T> q, EulerOrder order) {
+  BasicEulerAngle<T> result(0, 0, 0, order);
+  if (tryToEulerAngle(q, order, result) != ConversionError::None) {
+    throw "conversion of quaternion to euler angle is failed.";
+  }
+  return result;
+}
+
+template <EulerOrder O>
+class RotationMatrixToEulerAngle;
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::XYZ> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return m.at(0, 2);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sy = middleSine(m);
+    auto unlocked = constexprMath::abs(sy) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(-m.at(1, 2), m.at(2, 2)) : constexprMath::atan2(m.at(2, 1), m.at(1, 1)),
+      constexprMath::asin(sy),
+      unlocked ? constexprMath::atan2(-m.at(0, 1), m.at(0, 0)) : 0,
+      EulerOrder::XYZ
     );
-  } else if (order == EulerOrder::XZY) {
-    auto sz = -m.at(0, 1);
-    auto unlocked = std::abs(sz) < 0.99999f;
-    return EulerAngle(
-      unlocked ? std::atan2(m.at(2, 1), m.at(1, 1)) : std::atan2(-m.at(1, 2), m.at(2, 2)),
-      unlocked ? std::atan2(m.at(0, 2), m.at(0, 0)) : 0,
-      std::asin(sz),
-      order
+  }
+};
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::XZY> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return -m.at(0, 1);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sz = middleSine(m);
+    auto unlocked = constexprMath::abs(sz) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(m.at(2, 1), m.at(1, 1)) : constexprMath::atan2(-m.at(1, 2), m.at(2, 2)),
+      unlocked ? constexprMath::atan2(m.at(0, 2), m.at(0, 0)) : 0,
+      constexprMath::asin(sz),
+      EulerOrder::XZY
     );
-  } else if (order == EulerOrder::YXZ) {
-    auto sx = -m.at(1, 2);
-    auto unlocked = std::abs(sx) < 0.99999f;
-    return EulerAngle(
-      std::asin(sx),
-      unlocked ? std::atan2(m.at(0, 2), m.at(2, 2)) : std::atan2(-m.at(2, 0), m.at(0, 0)),
-      unlocked ? std::atan2(m.at(1, 0), m.at(1, 1)) : 0,
-      order
+  }
+};
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::YXZ> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return -m.at(1, 2);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sx = middleSine(m);
+    auto unlocked = constexprMath::abs(sx) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      constexprMath::asin(sx),
+      unlocked ? constexprMath::atan2(m.at(0, 2), m.at(2, 2)) : constexprMath::atan2(-m.at(2, 0), m.at(0, 0)),
+      unlocked ? constexprMath::atan2(m.at(1, 0), m.at(1, 1)) : 0,
+      EulerOrder::YXZ
     );
-  } else if (order == EulerOrder::YZX) {
-    auto sz = m.at(1, 0);
-    auto unlocked = std::abs(sz) < 0.99999f;
-    return EulerAngle(
-      unlocked ? atan2(-m.at(1, 2), m.at(1, 1)) : 0,
-      unlocked ? atan2(-m.at(2, 0), m.at(0, 0)) : atan2(m.at(0, 2), m.at(2, 2)),
-      std::asin(sz),
-      order
+  }
+};
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::YZX> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return m.at(1, 0);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sz = middleSine(m);
+    auto unlocked = constexprMath::abs(sz) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(-m.at(1, 2), m.at(1, 1)) : 0,
+      unlocked ? constexprMath::atan2(-m.at(2, 0), m.at(0, 0)) : constexprMath::atan2(m.at(0, 2), m.at(2, 2)),
+      constexprMath::asin(sz),
+      EulerOrder::YZX
     );
-  } else if (order == EulerOrder::ZXY) {
-    auto sx = m.at(2, 1);
-    auto unlocked = std::abs(sx) < 0.99999f;
-    return EulerAngle(
-      std::asin(sx),
-      unlocked ? std::atan2(-m.at(2, 0), m.at(2, 2)) : 0,
-      unlocked ? std::atan2(-m.at(0, 1), m.at(1, 1)) : std::atan2(m.at(1, 0), m.at(0, 0)),
-      order
+  }
+};
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::ZXY> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return m.at(2, 1);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sx = middleSine(m);
+    auto unlocked = constexprMath::abs(sx) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      constexprMath::asin(sx),
+      unlocked ? constexprMath::atan2(-m.at(2, 0), m.at(2, 2)) : 0,
+      unlocked ? constexprMath::atan2(-m.at(0, 1), m.at(1, 1)) : constexprMath::atan2(m.at(1, 0), m.at(0, 0)),
+      EulerOrder::ZXY
     );
-  } else if (order == EulerOrder::ZYX) {
-    auto sy = -m.at(2, 0);
-    auto unlocked = std::abs(sy) < 0.99999f;
-    return EulerAngle(
-      unlocked ? std::atan2(m.at(2, 1), m.at(2, 2)) : 0,
-      std::asin(sy),
-      unlocked ? std::atan2(m.at(1, 0), m.at(0, 0)) : std::atan2(-m.at(0, 1), m.at(1, 1)),
-      order
+  }
+};
+
+template <>
+class RotationMatrixToEulerAngle<EulerOrder::ZYX> {
+public:
+  template <typename T>
+  static constexpr T middleSine(const BasicRotationMatrix<T>& m) noexcept {
+    return -m.at(2, 0);
+  }
+  template <typename T>
+  static constexpr BasicEulerAngle<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto sy = middleSine(m);
+    auto unlocked = constexprMath::abs(sy) < GIMBAL_LOCK_SINE;
+    return BasicEulerAngle<T>(
+      unlocked ? constexprMath::atan2(m.at(2, 1), m.at(2, 2)) : 0,
+      constexprMath::asin(sy),
+      unlocked ? constexprMath::atan2(m.at(1, 0), m.at(0, 0)) : constexprMath::atan2(-m.at(0, 1), m.at(1, 1)),
+      EulerOrder::ZYX
     );
   }
-  throw "conversion of rotation matrix to euler angle is failed.";
+};
+
+template <EulerOrder O, typename T>
+constexpr BasicEulerAngle<T> toEulerAngle(BasicRotationMatrix<T> m) noexcept {
+  return RotationMatrixToEulerAngle<O>::convert(m);
 }
 
-Quaternion toQuaternion(EulerAngle e) {
-  auto cx = std::cos(0.5f * e.x);
-  auto sx = std::sin(0.5f * e.x);
-  auto cy = std::cos(0.5f * e.y);
-  auto sy = std::sin(0.5f * e.y);
-  auto cz = std::cos(0.5f * e.z);
-  auto sz = std::sin(0.5f * e.z);
-  switch (e.order) {
-  case EulerOrder::XYZ:
-    return Quaternion(
+template <EulerOrder O, typename T>
+constexpr bool isGimbalLocked(const BasicRotationMatrix<T>& m) noexcept {
+  return !(constexprMath::abs(RotationMatrixToEulerAngle<O>::middleSine(m)) < GIMBAL_LOCK_SINE);
+}
+
+template <typename T>
+ConversionError tryToEulerAngle(const BasicRotationMatrix<T>& m, EulerOrder order, BasicEulerAngle<T>& result) noexcept {
+  using Conversion = BasicEulerAngle<T> (*)(BasicRotationMatrix<T>);
+  static constexpr Conversion conversions[] = {
+    toEulerAngle<EulerOrder::XYZ, T>,
+    toEulerAngle<EulerOrder::XZY, T>,
+    toEulerAngle<EulerOrder::YXZ, T>,
+    toEulerAngle<EulerOrder::YZX, T>,
+    toEulerAngle<EulerOrder::ZXY, T>,
+    toEulerAngle<EulerOrder::ZYX, T>
+  };
+  auto index = static_cast<size_t>(order);
+  if (index >= sizeof(conversions) / sizeof(conversions[0])) {
+    return ConversionError::InvalidEulerOrder;
+  }
+  result = conversions[index](m);
+  return ConversionError::None;
+}
+
+template <typename T>
+BasicEulerAngle<T> toEulerAngle(BasicRotationMatrix<T> m, EulerOrder order) {
+  BasicEulerAngle<T> result(0, 0, 0, order);
+  if (tryToEulerAngle(m, order, result) != ConversionError::None) {
+    throw "conversion of rotation matrix to euler angle is failed.";
+  }
+  return result;
+}
+
+template <EulerOrder O>
+class EulerAngleToQuaternion;
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::XYZ> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       cx * sy * sz + sx * cy * cz,
       -sx * cy * sz + cx * sy * cz,
       cx * cy * sz + sx * sy * cz,
       -sx * sy * sz + cx * cy * cz
     );
-  case EulerOrder::XZY:
-    return Quaternion(
+  }
+};
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::XZY> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       -cx * sy * sz + sx * cy * cz,
       cx * sy * cz - sx * cy * sz,
       sx * sy * cz + cx * cy * sz,
       sx * sy * sz + cx * cy * cz
     );
-  case EulerOrder::YXZ:
-    return Quaternion(
+  }
+};
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::YXZ> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       cx * sy * sz + sx * cy * cz,
       -sx * cy * sz + cx * sy * cz,
       cx * cy * sz - sx * sy * cz,
       sx * sy * sz + cx * cy * cz
     );
-  case EulerOrder::YZX:
-    return Quaternion(
+  }
+};
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::YZX> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       sx * cy * cz + cx * sy * sz,
       sx * cy * sz + cx * sy * cz,
       -sx * sy * cz + cx * cy * sz,
       -sx * sy * sz + cx * cy * cz
     );
-  case EulerOrder::ZXY:
-    return Quaternion(
+  }
+};
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::ZXY> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       -cx * sy * sz + sx * cy * cz,
       cx * sy * cz + sx * cy * sz,
       sx * sy * cz + cx * cy * sz,
       -sx * sy * sz + cx * cy * cz
     );
-  case EulerOrder::ZYX:
-    return Quaternion(
+  }
+};
+
+template <>
+class EulerAngleToQuaternion<EulerOrder::ZYX> {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicQuaternion<T>(
       sx * cy * cz - cx * sy * sz,
       sx * cy * sz + cx * sy * cz,
       -sx * sy * cz + cx * cy * sz,
       sx * sy * sz + cx * cy * cz
     );
   }
-  throw "conversion of euler angle to quaterion is failed.";
+};
+
+template <EulerOrder O, TrigPrecision P = TrigPrecision::Exact, typename T>
+constexpr BasicQuaternion<T> toQuaternion(BasicEulerAngle<T> e) noexcept {
+  T cx = 0, sx = 0, cy = 0, sy = 0, cz = 0, sz = 0;
+  sinCos<P>(0.5f * e.x, sx, cx);
+  sinCos<P>(0.5f * e.y, sy, cy);
+  sinCos<P>(0.5f * e.z, sz, cz);
+  return EulerAngleToQuaternion<O>::convert(cx, sx, cy, sy, cz, sz);
 }
 
-Quaternion toQuaternion(RotationMatrix m) {
-  auto px = m.at(0, 0) - m.at(1, 1) - m.at(2, 2) + 1;
-  auto py = -m.at(0, 0) + m.at(1, 1) - m.at(2, 2) + 1;
-  auto pz = -m.at(0, 0) - m.at(1, 1) + m.at(2, 2) + 1;
-  auto pw = m.at(0, 0) + m.at(1, 1) + m.at(2, 2) + 1;
-
-  auto selected = 0;
-  auto max = px;
-  if (max < py) {
-    selected = 1;
-    max = py;
-  }
-  if (max < pz) {
-    selected = 2;
-    max = pz;
-  }
-  if (max < pw) {
-    selected = 3;
-    max = pw;
-  }
-
-  if (selected == 0) {
-    auto x = std::sqrt(px) * 0.5f;
-    auto d = 1 / (4 * x);
-    return Quaternion(
-      x,
-      (m.at(1, 0) + m.at(0, 1)) * d,
-      (m.at(0, 2) + m.at(2, 0)) * d,
-      (m.at(2, 1) - m.at(1, 2)) * d
-    );
-  } else if (selected == 1) {
-    auto y = std::sqrt(py) * 0.5f;
-    auto d = 1 / (4 * y);
-    return Quaternion(
-      (m.at(1, 0) + m.at(0, 1)) * d,
-      y,
-      (m.at(2, 1) + m.at(1, 2)) * d,
-      (m.at(0, 2) - m.at(2, 0)) * d
-    );
-  } else if (selected == 2) {
-    auto z = std::sqrt(pz) * 0.5f;
-    auto d = 1 / (4 * z);
-    return Quaternion(
-      (m.at(0, 2) + m.at(2, 0)) * d,
-      (m.at(2, 1) + m.at(1, 2)) * d,
-      z,
-      (m.at(1, 0) - m.at(0, 1)) * d
-    );
-  } else if (selected == 3) {
-    auto w = std::sqrt(pw) * 0.5f;
-    auto d = 1 / (4 * w);
-    return Quaternion(
-      (m.at(2, 1) - m.at(1, 2)) * d,
-      (m.at(0, 2) - m.at(2, 0)) * d,
-      (m.at(1, 0) - m.at(0, 1)) * d,
-      w
-    );
+template <TrigPrecision P = TrigPrecision::Exact, typename T>
+ConversionError tryToQuaternion(const BasicEulerAngle<T>& e, BasicQuaternion<T>& result) noexcept {
+  using Conversion = BasicQuaternion<T> (*)(BasicEulerAngle<T>);
+  static constexpr Conversion conversions[] = {
+    toQuaternion<EulerOrder::XYZ, P, T>,
+    toQuaternion<EulerOrder::XZY, P, T>,
+    toQuaternion<EulerOrder::YXZ, P, T>,
+    toQuaternion<EulerOrder::YZX, P, T>,
+    toQuaternion<EulerOrder::ZXY, P, T>,
+    toQuaternion<EulerOrder::ZYX, P, T>
+  };
+  auto index = static_cast<size_t>(e.order);
+  if (index >= sizeof(conversions) / sizeof(conversions[0])) {
+    return ConversionError::InvalidEulerOrder;
   }
-  throw "conversion of rotation matrix to quaterion is failed.";
+  result = conversions[index](e);
+  return ConversionError::None;
 }
 
-RotationMatrix toRotationMatrix(EulerAngle e) {
-  auto cx = std::cos(e.x);
-  auto sx = std::sin(e.x);
-  auto cy = std::cos(e.y);
-  auto sy = std::sin(e.y);
-  auto cz = std::cos(e.z);
-  auto sz = std::sin(e.z);
-  switch (e.order) {
-  case EulerOrder::XYZ:
-    return RotationMatrix({
+template <TrigPrecision P, typename T>
+BasicQuaternion<T> toQuaternion(BasicEulerAngle<T> e) {
+  BasicQuaternion<T> result(0, 0, 0, 1);
+  if (tryToQuaternion<P>(e, result) != ConversionError::None) {
+    throw "conversion of euler angle to quaterion is failed.";
+  }
+  return result;
+}
+
+template <typename T>
+BasicQuaternion<T> toQuaternion(BasicEulerAngle<T> e) {
+  return toQuaternion<TrigPrecision::Exact>(e);
+}
+
+class RotationMatrixToQuaternion {
+public:
+  template <typename T>
+  static constexpr BasicQuaternion<T> convert(const BasicRotationMatrix<T>& m) noexcept {
+    auto px = m.at(0, 0) - m.at(1, 1) - m.at(2, 2) + 1;
+    auto py = -m.at(0, 0) + m.at(1, 1) - m.at(2, 2) + 1;
+    auto pz = -m.at(0, 0) - m.at(1, 1) + m.at(2, 2) + 1;
+    auto pw = m.at(0, 0) + m.at(1, 1) + m.at(2, 2) + 1;
+
+    auto selected = 0;
+    auto max = px;
+    if (max < py) {
+      selected = 1;
+      max = py;
+    }
+    if (max < pz) {
+      selected = 2;
+      max = pz;
+    }
+    if (max < pw) {
+      selected = 3;
+      max = pw;
+    }
+
+    if (selected == 0) {
+      auto x = constexprMath::sqrt(px) * 0.5f;
+      auto d = 1 / (4 * x);
+      return BasicQuaternion<T>(
+        x,
+        (m.at(1, 0) + m.at(0, 1)) * d,
+        (m.at(0, 2) + m.at(2, 0)) * d,
+        (m.at(2, 1) - m.at(1, 2)) * d
+      );
+    } else if (selected == 1) {
+      auto y = constexprMath::sqrt(py) * 0.5f;
+      auto d = 1 / (4 * y);
+      return BasicQuaternion<T>(
+        (m.at(1, 0) + m.at(0, 1)) * d,
+        y,
+        (m.at(2, 1) + m.at(1, 2)) * d,
+        (m.at(0, 2) - m.at(2, 0)) * d
+      );
+    } else if (selected == 2) {
+      auto z = constexprMath::sqrt(pz) * 0.5f;
+      auto d = 1 / (4 * z);
+      return BasicQuaternion<T>(
+        (m.at(0, 2) + m.at(2, 0)) * d,
+        (m.at(2, 1) + m.at(1, 2)) * d,
+        z,
+        (m.at(1, 0) - m.at(0, 1)) * d
+      );
+    } else {
+      auto w = constexprMath::sqrt(pw) * 0.5f;
+      auto d = 1 / (4 * w);
+      return BasicQuaternion<T>(
+        (m.at(2, 1) - m.at(1, 2)) * d,
+        (m.at(0, 2) - m.at(2, 0)) * d,
+        (m.at(1, 0) - m.at(0, 1)) * d,
+        w
+      );
+    }
+  }
+};
+
+template <typename T>
+constexpr BasicQuaternion<T> toQuaternion(BasicRotationMatrix<T> m) noexcept {
+  return RotationMatrixToQuaternion::convert(m);
+}
+
+template <EulerOrder O>
+class EulerAngleToRotationMatrix;
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::XYZ> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       cy * cz, sx * sy * cz + cx * sz, -cx * sy * cz + sx * sz,
       -cy * sz, -sx * sy * sz + cx * cz, cx * sy * sz + sx * cz,
       sy, -sx * cy, cx * cy
     });
-  case EulerOrder::XZY:
-    return RotationMatrix({
+  }
+};
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::XZY> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       cy * cz, cx * cy * sz + sx * sy, sx * cy * sz - cx * sy,
       -sz, cx * cz, sx * cz,
       sy * cz, cx * sy * sz - sx * cy, sx * sy * sz + cx * cy
     });
-  case EulerOrder::YXZ:
-    return RotationMatrix({
+  }
+};
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::YXZ> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       sx * sy * sz + cy * cz, cx * sz, sx * cy * sz - sy * cz,
       sx * sy * cz - cy * sz, cx * cz, sx * cy * cz + sy * sz,
       cx * sy, -sx, cx * cy
     });
-  case EulerOrder::YZX:
-    return RotationMatrix({
+  }
+};
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::YZX> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       cy * cz, sz, -sy * cz,
       -cx * cy * sz + sx * sy, cx * cz, cx * sy * sz + sx * cy,
       sx * cy * sz + cx * sy, -sx * cz, -sx * sy * sz + cx * cy
     });
-  case EulerOrder::ZXY:
-    return RotationMatrix({
+  }
+};
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::ZXY> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       -sx * sy * sz + cy * cz, sx * sy * cz + cy * sz, -cx * sy,
       -cx * sz, cx * cz, sx,
       sx * cy * sz + sy * cz, -sx * cy * cz + sy * sz, cx * cy
     });
-  case EulerOrder::ZYX:
-    return RotationMatrix({
+  }
+};
+
+template <>
+class EulerAngleToRotationMatrix<EulerOrder::ZYX> {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(T cx, T sx, T cy, T sy, T cz, T sz) noexcept {
+    return BasicRotationMatrix<T>({
       cy * cz, cy * sz, -sy,
       sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy,
       cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy
     });
   }
-  throw "conversion of euler angle to rotation matrix is failed.";
+};
+
+template <EulerOrder O, typename T>
+constexpr BasicRotationMatrix<T> toRotationMatrix(BasicEulerAngle<T> e) noexcept {
+  return EulerAngleToRotationMatrix<O>::convert(constexprMath::cos(e.x), constexprMath::sin(e.x), constexprMath::cos(e.y), constexprMath::sin(e.y), constexprMath::cos(e.z), constexprMath::sin(e.z));
+}
+
+template <typename T>
+ConversionError tryToRotationMatrix(const BasicEulerAngle<T>& e, BasicRotationMatrix<T>& result) noexcept {
+  using Conversion = BasicRotationMatrix<T> (*)(BasicEulerAngle<T>);
+  static constexpr Conversion conversions[] = {
+    toRotationMatrix<EulerOrder::XYZ, T>,
+    toRotationMatrix<EulerOrder::XZY, T>,
+    toRotationMatrix<EulerOrder::YXZ, T>,
+    toRotationMatrix<EulerOrder::YZX, T>,
+    toRotationMatrix<EulerOrder::ZXY, T>,
+    toRotationMatrix<EulerOrder::ZYX, T>
+  };
+  auto index = static_cast<size_t>(e.order);
+  if (index >= sizeof(conversions) / sizeof(conversions[0])) {
+    return ConversionError::InvalidEulerOrder;
+  }
+  result = conversions[index](e);
+  return ConversionError::None;
+}
+
+template <typename T>
+BasicRotationMatrix<T> toRotationMatrix(BasicEulerAngle<T> e) {
+  BasicRotationMatrix<T> result({ 1, 0, 0, 0, 1, 0, 0, 0, 1 });
+  if (tryToRotationMatrix(e, result) != ConversionError::None) {
+    throw "conversion of euler angle to rotation matrix is failed.";
+  }
+  return result;
 }
 
-RotationMatrix toRotationMatrix(Quaternion q) {
-  auto xy2 = q.x * q.y * 2;
-  auto xz2 = q.x * q.z * 2;
-  auto xw2 = q.x * q.w * 2;
-  auto yz2 = q.y * q.z * 2;
-  auto yw2 = q.y * q.w * 2;
-  auto zw2 = q.z * q.w * 2;
-  auto ww2 = q.w * q.w * 2;
-  return RotationMatrix({
-    ww2 + 2 * q.x * q.x - 1, xy2 + zw2, xz2 - yw2,
-    xy2 - zw2, ww2 + 2 * q.y * q.y - 1, yz2 + xw2,
-    xz2 + yw2, yz2 - xw2, ww2 + 2 * q.z * q.z - 1 
-  });
+class QuaternionToRotationMatrix {
+public:
+  template <typename T>
+  static constexpr BasicRotationMatrix<T> convert(const BasicQuaternion<T>& q) noexcept {
+    auto xy2 = q.x * q.y * 2;
+    auto xz2 = q.x * q.z * 2;
+    auto xw2 = q.x * q.w * 2;
+    auto yz2 = q.y * q.z * 2;
+    auto yw2 = q.y * q.w * 2;
+    auto zw2 = q.z * q.w * 2;
+    auto ww2 = q.w * q.w * 2;
+    return BasicRotationMatrix<T>({
+      ww2 + 2 * q.x * q.x - 1, xy2 + zw2, xz2 - yw2,
+      xy2 - zw2, ww2 + 2 * q.y * q.y - 1, yz2 + xw2,
+      xz2 + yw2, yz2 - xw2, ww2 + 2 * q.z * q.z - 1 
+    });
+  }
+};
+
+template <typename T>
+constexpr BasicRotationMatrix<T> toRotationMatrix(BasicQuaternion<T> q) noexcept {
+  return QuaternionToRotationMatrix::convert(q);
 }
 
 #endif // __CONVERSION_H__
\ No newline at end of file
@@ -0,0 +1,203 @@
+#ifndef __EXECUTIONCONVERSION_H__
+#define __EXECUTIONCONVERSION_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <compare>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./batchConversion.h"
+#include "./conversion.h"
+
+// Conversions over iterator ranges taking a standard execution policy, in the shape of std::transform: they return
+// the end of the written output range, and outputs must be forward iterators to already constructed objects.
+//
+// With std::execution::par_unseq on random access ranges of float rotations, conversions that have a SIMD batch kernel
+// gather chunks of EXECUTION_CHUNK elements into SoA buffers on the stack and run the kernel, so they match the batch
+// functions of batchConversion.h rather than the scalar ones. Every other combination calls the scalar conversions
+// with the euler order dispatch hoisted out of the loop. Euler orders are checked before the algorithm starts, which
+// then only runs noexcept code, and the SIMD tier is read once up front.
+
+template <class ExecutionPolicy>
+using EnableIfExecutionPolicy = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>, int>;
+
+const size_t EXECUTION_CHUNK = 256;
+
+template <class ExecutionPolicy, class InputIt, class OutputIt, class Input, class Output>
+constexpr bool usesBatchKernel() {
+  return std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::parallel_unsequenced_policy> &&
+    std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> &&
+    std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<OutputIt>::iterator_category> &&
+    std::is_same_v<typename std::iterator_traits<InputIt>::value_type, Input> &&
+    std::is_same_v<std::remove_cv_t<typename std::iterator_traits<OutputIt>::value_type>, Output>;
+}
+
+// Random access iterator over the chunk indices 0, 1, 2, ..., so the parallel algorithms can split the chunks
+// without a materialized index array. std::views::iota is no substitute: its iterators are only input iterators to
+// the parallel algorithms, which then run sequentially.
+class ChunkIterator {
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const size_t*;
+  using reference = size_t;
+  ChunkIterator(): chunk(0) {}
+  explicit ChunkIterator(size_t chunk): chunk(chunk) {}
+  size_t operator*() const { return chunk; }
+  size_t operator[](difference_type n) const { return chunk + n; }
+  ChunkIterator& operator++() { chunk++; return *this; }
+  ChunkIterator operator++(int) { return ChunkIterator(chunk++); }
+  ChunkIterator& operator--() { chunk--; return *this; }
+  ChunkIterator operator--(int) { return ChunkIterator(chunk--); }
+  ChunkIterator& operator+=(difference_type n) { chunk += n; return *this; }
+  ChunkIterator& operator-=(difference_type n) { chunk -= n; return *this; }
+  ChunkIterator operator+(difference_type n) const { return ChunkIterator(chunk + n); }
+  friend ChunkIterator operator+(difference_type n, ChunkIterator i) { return i + n; }
+  ChunkIterator operator-(difference_type n) const { return ChunkIterator(chunk - n); }
+  difference_type operator-(ChunkIterator other) const { return static_cast<difference_type>(chunk - other.chunk); }
+  auto operator<=>(const ChunkIterator&) const = default;
+
+private:
+  size_t chunk;
+};
+
+// Runs convertChunk(input, count, output) over consecutive chunks of the range under the given policy.
+template <class ExecutionPolicy, class InputIt, class OutputIt, class F>
+OutputIt transformChunks(ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt result, F convertChunk) {
+  auto count = static_cast<size_t>(std::distance(first, last));
+  ChunkIterator end((count + EXECUTION_CHUNK - 1) / EXECUTION_CHUNK);
+  std::for_each(std::forward<ExecutionPolicy>(policy), ChunkIterator(), end, [&](size_t chunk) {
+    auto begin = chunk * EXECUTION_CHUNK;
+    convertChunk(first + begin, std::min(EXECUTION_CHUNK, count - begin), result + begin);
+  });
+  return result + count;
+}
+
+template <class R>
+constexpr bool isEulerAngle = false;
+
+template <typename T>
+constexpr bool isEulerAngle<BasicEulerAngle<T>> = true;
+
+// Throws before the algorithm starts if any euler angle of the range has an invalid order, so that the element
+// functions can call the noexcept conversions: an exception escaping a parallel algorithm calls std::terminate.
+template <class InputIt>
+void checkEulerOrders(InputIt first, InputIt last) {
+  if constexpr (isEulerAngle<typename std::iterator_traits<InputIt>::value_type>) {
+    if (!std::all_of(first, last, [](const auto& e) { return isValidEulerOrder(e.order); })) {
+      throw "euler order is invalid.";
+    }
+  }
+}
+
+template <class ExecutionPolicy, class InputIt, class OutputIt, EnableIfExecutionPolicy<ExecutionPolicy> = 0>
+OutputIt toEulerAngle(ExecutionPolicy&& policy, InputIt first, InputIt last, EulerOrder order, OutputIt result) {
+  if (!isValidEulerOrder(order)) {
+    throw "euler order is invalid.";
+  }
+  if constexpr (usesBatchKernel<ExecutionPolicy, InputIt, OutputIt, Quaternion, EulerAngle>()) {
+    auto tier = simd::tier();
+    return transformChunks(std::forward<ExecutionPolicy>(policy), first, last, result,
+        [order, tier](InputIt input, size_t count, OutputIt output) {
+      // Initialized only to keep -Wmaybe-uninitialized quiet about the tail past count, which is never read.
+      float x[EXECUTION_CHUNK] = {}, y[EXECUTION_CHUNK] = {}, z[EXECUTION_CHUNK] = {}, w[EXECUTION_CHUNK] = {};
+      for (size_t i = 0; i < count; i++) {
+        x[i] = input[i].x;
+        y[i] = input[i].y;
+        z[i] = input[i].z;
+        w[i] = input[i].w;
+      }
+      tryToEulerAngleBatch(tier, x, y, z, w, count, order, x, y, z);
+      for (size_t i = 0; i < count; i++) {
+        output[i] = EulerAngle(x[i], y[i], z[i], order);
+      }
+    });
+  } else {
+    return withEulerOrder(order, [&](auto o) {
+      return std::transform(std::forward<ExecutionPolicy>(policy), first, last, result, [](const auto& r) {
+        return toEulerAngle<decltype(o)::value>(r);
+      });
+    });
+  }
+}
+
+template <class ExecutionPolicy, class InputIt, class OutputIt, EnableIfExecutionPolicy<ExecutionPolicy> = 0>
+OutputIt toQuaternion(ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt result) {
+  if constexpr (usesBatchKernel<ExecutionPolicy, InputIt, OutputIt, RotationMatrix, Quaternion>()) {
+    auto tier = simd::tier();
+    return transformChunks(std::forward<ExecutionPolicy>(policy), first, last, result,
+        [tier](InputIt input, size_t count, OutputIt output) {
+      float elements[9 * EXECUTION_CHUNK] = {};
+      float x[EXECUTION_CHUNK], y[EXECUTION_CHUNK], z[EXECUTION_CHUNK], w[EXECUTION_CHUNK];
+      for (size_t i = 0; i < count; i++) {
+        std::copy(input[i].elements.begin(), input[i].elements.end(), elements + 9 * i);
+      }
+      toQuaternionBatch(tier, elements, count, x, y, z, w);
+      for (size_t i = 0; i < count; i++) {
+        output[i] = Quaternion(x[i], y[i], z[i], w[i]);
+      }
+    });
+  } else {
+    checkEulerOrders(first, last);
+    return std::transform(std::forward<ExecutionPolicy>(policy), first, last, result, [](const auto& r) {
+      if constexpr (isEulerAngle<std::decay_t<decltype(r)>>) {
+        BasicQuaternion<decltype(r.x)> q(0, 0, 0, 1);
+        tryToQuaternion(r, q);
+        return q;
+      } else {
+        return toQuaternion(r);
+      }
+    });
+  }
+}
+
+template <class ExecutionPolicy, class InputIt, class OutputIt, EnableIfExecutionPolicy<ExecutionPolicy> = 0>
+OutputIt toRotationMatrix(ExecutionPolicy&& policy, InputIt first, InputIt last, OutputIt result) {
+  checkEulerOrders(first, last);
+  // Same as the scalar conversion for any rotation, without the throwing order dispatch.
+  auto convert = [](const auto& r) {
+    if constexpr (isEulerAngle<std::decay_t<decltype(r)>>) {
+      BasicRotationMatrix<decltype(r.x)> m({ 1, 0, 0, 0, 1, 0, 0, 0, 1 });
+      tryToRotationMatrix(r, m);
+      return m;
+    } else {
+      return toRotationMatrix(r);
+    }
+  };
+  if constexpr (usesBatchKernel<ExecutionPolicy, InputIt, OutputIt, EulerAngle, RotationMatrix>()) {
+    auto tier = simd::tier();
+    return transformChunks(std::forward<ExecutionPolicy>(policy), first, last, result,
+        [tier, convert](InputIt input, size_t count, OutputIt output) {
+      // The batch kernel takes one order, so chunks mixing orders fall back to the scalar conversion.
+      auto order = input[0].order;
+      for (size_t i = 1; i < count; i++) {
+        if (input[i].order != order) {
+          std::transform(input, input + count, output, convert);
+          return;
+        }
+      }
+      float x[EXECUTION_CHUNK] = {}, y[EXECUTION_CHUNK] = {}, z[EXECUTION_CHUNK] = {};
+      float elements[9 * EXECUTION_CHUNK];
+      for (size_t i = 0; i < count; i++) {
+        x[i] = input[i].x;
+        y[i] = input[i].y;
+        z[i] = input[i].z;
+      }
+      tryToRotationMatrixBatch(tier, x, y, z, count, order, elements);
+      for (size_t i = 0; i < count; i++) {
+        std::copy(elements + 9 * i, elements + 9 * i + 9, output[i].elements.begin());
+      }
+    });
+  } else {
+    return std::transform(std::forward<ExecutionPolicy>(policy), first, last, result, convert);
+  }
+}
+
+#endif // __EXECUTIONCONVERSION_H__
@@ -0,0 +1,86 @@
+#ifndef __HIERARCHY_H__
+#define __HIERARCHY_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./ThreadPool.h"
+#include "./parallelConversion.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./hierarchyKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// World rotations of a joint hierarchy: world[j] = world[parents[j]] * local[j], or local[j] for a root, whose
+// parent index is NO_PARENT. Parents must come before their children, which makes one forward sweep enough.
+
+const int32_t NO_PARENT = -1;
+
+void checkParents(const int32_t* parents, size_t count) {
+  for (size_t j = 0; j < count; j++) {
+    if (parents[j] < NO_PARENT || parents[j] >= static_cast<int64_t>(j)) {
+      throw "parent indices are not topologically sorted.";
+    }
+  }
+}
+
+template <typename T>
+void composeHierarchy(const BasicQuaternion<T>* local, const int32_t* parents, size_t count, BasicQuaternion<T>* world) {
+  checkParents(parents, count);
+  for (size_t j = 0; j < count; j++) {
+    world[j] = parents[j] == NO_PARENT ? local[j] : world[parents[j]] * local[j];
+  }
+}
+
+template <typename T>
+void composeHierarchy(const BasicRotationMatrix<T>* local, const int32_t* parents, size_t count, BasicRotationMatrix<T>* world) {
+  checkParents(parents, count);
+  for (size_t j = 0; j < count; j++) {
+    world[j] = parents[j] == NO_PARENT ? local[j] : world[parents[j]] * local[j];
+  }
+}
+
+// Many instances of one hierarchy, e.g. the characters sharing a skeleton. Components are stored joint-major: the
+// x of joint j for instance i is lx[j * instanceCount + i]. Each joint is one SIMD pass over all instances, so the
+// sweep reads and writes contiguous rows; the outputs may alias the inputs.
+void composeHierarchyBatch(const int32_t* parents, size_t jointCount, size_t instanceCount,
+    const float* lx, const float* ly, const float* lz, const float* lw, float* wx, float* wy, float* wz, float* ww) {
+  checkParents(parents, jointCount);
+  SIMD_DISPATCH(composeHierarchyRows, parents, jointCount, instanceCount, instanceCount, lx, ly, lz, lw, wx, wy, wz, ww);
+}
+
+namespace detail {
+
+// Sweeps instances [0, count) of rows of stride floats; callers check the parents.
+void composeHierarchyRange(const int32_t* parents, size_t jointCount, size_t stride, size_t count,
+    const float* lx, const float* ly, const float* lz, const float* lw, float* wx, float* wy, float* wz, float* ww) {
+  SIMD_DISPATCH(composeHierarchyRows, parents, jointCount, stride, count, lx, ly, lz, lw, wx, wy, wz, ww);
+}
+
+} // namespace detail
+
+const size_t CACHE_LINE_BYTES = 64;
+
+// Same, with instances split into ranges that are swept in parallel; instances never depend on each other. Range
+// boundaries fall on the 64-byte lines of wx counted from its first row, and the grain is a whole number of lines,
+// so tasks never write to the same line of a row when instanceCount is a multiple of 16.
+void composeHierarchyBatch(ThreadPool& pool, const int32_t* parents, size_t jointCount, size_t instanceCount,
+    const float* lx, const float* ly, const float* lz, const float* lw, float* wx, float* wy, float* wz, float* ww) {
+  checkParents(parents, jointCount);
+  const size_t lineFloats = CACHE_LINE_BYTES / sizeof(float);
+  auto offset = reinterpret_cast<uintptr_t>(wx) % CACHE_LINE_BYTES / sizeof(float);
+  auto grain = parallelChunkSize(jointCount * 8 * sizeof(float));
+  grain = (grain + lineFloats - 1) / lineFloats * lineFloats;
+  // Index i of the loop is instance i - offset, so the first range is shortened up to the first line boundary.
+  pool.parallelFor(instanceCount + offset, grain, [&](size_t begin, size_t end) {
+    begin = begin < offset ? 0 : begin - offset;
+    end -= offset;
+    detail::composeHierarchyRange(parents, jointCount, instanceCount, end - begin, lx + begin, ly + begin, lz + begin,
+      lw + begin, wx + begin, wy + begin, wz + begin, ww + begin);
+  });
+}
+
+#endif // __HIERARCHY_H__
@@ -0,0 +1,57 @@
+// Lane-generic kernels behind hierarchy.h, included once per SIMD target through simdTargets.h.
+
+// Same product as BasicQuaternion::operator*.
+template <class V>
+void multiplyLanes(const V ax, const V ay, const V az, const V aw, const V bx, const V by, const V bz, const V bw,
+    V& rx, V& ry, V& rz, V& rw) {
+  rx = aw * bx - az * by + ay * bz + ax * bw;
+  ry = az * bx + aw * by - ax * bz + ay * bw;
+  rz = -ay * bx + ax * by + aw * bz + az * bw;
+  rw = -ax * bx - ay * by - az * bz + aw * bw;
+}
+
+// Rows of count instances: r = a * b lane by lane. r may alias b but not a.
+template <class V>
+void multiplyRow(const float* ax, const float* ay, const float* az, const float* aw,
+    const float* bx, const float* by, const float* bz, const float* bw, size_t count,
+    float* rx, float* ry, float* rz, float* rw) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V x, y, z, w;
+    multiplyLanes(V::load(ax + i), V::load(ay + i), V::load(az + i), V::load(aw + i),
+      V::load(bx + i), V::load(by + i), V::load(bz + i), V::load(bw + i), x, y, z, w);
+    x.store(rx + i);
+    y.store(ry + i);
+    z.store(rz + i);
+    w.store(rw + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 x, y, z, w;
+    multiplyLanes<simd::Float1>(ax[i], ay[i], az[i], aw[i], bx[i], by[i], bz[i], bw[i], x, y, z, w);
+    rx[i] = x.v;
+    ry[i] = y.v;
+    rz[i] = z.v;
+    rw[i] = w.v;
+  }
+}
+
+// Component arrays are joint-major with rows of stride floats, of which instances [0, count) are processed.
+template <class V>
+void composeHierarchyRows(const int32_t* parents, size_t jointCount, size_t stride, size_t count,
+    const float* lx, const float* ly, const float* lz, const float* lw, float* wx, float* wy, float* wz, float* ww) {
+  for (size_t j = 0; j < jointCount; j++) {
+    auto row = j * stride;
+    if (parents[j] < 0) {
+      for (size_t i = 0; i < count; i++) {
+        wx[row + i] = lx[row + i];
+        wy[row + i] = ly[row + i];
+        wz[row + i] = lz[row + i];
+        ww[row + i] = lw[row + i];
+      }
+      continue;
+    }
+    auto parent = static_cast<size_t>(parents[j]) * stride;
+    multiplyRow<V>(wx + parent, wy + parent, wz + parent, ww + parent, lx + row, ly + row, lz + row, lw + row, count,
+      wx + row, wy + row, wz + row, ww + row);
+  }
+}
@@ -0,0 +1,90 @@
+// Lane-generic kernels behind batchInterpolation.h, included once per SIMD target through simdTargets.h.
+
+// Same arithmetic as slerp and nlerp of Quaternion.h, with the nearly parallel fallback selected per lane.
+template <class V>
+void interpolateLanes(const V ax, const V ay, const V az, const V aw, V bx, V by, V bz, V bw, const V t,
+    bool spherical, V& rx, V& ry, V& rz, V& rw) {
+  auto d = ax * bx + ay * by + az * bz + aw * bw;
+  auto negative = d < V(0);
+  bx = simd::select(negative, -bx, bx);
+  by = simd::select(negative, -by, by);
+  bz = simd::select(negative, -bz, bz);
+  bw = simd::select(negative, -bw, bw);
+  auto wa = V(1) - t;
+  auto wb = t;
+  if (spherical) {
+    d = abs(d);
+    auto linear = d > V(0.9995f);
+    auto sinTheta = sqrt(max(V(1) - d * d, V(0)));
+    auto theta = atan2(sinTheta, d);
+    V sa, ca, sb, cb;
+    sincos(wa * theta, sa, ca);
+    sincos(t * theta, sb, cb);
+    auto inverseSin = V(1) / simd::select(linear, V(1), sinTheta);
+    wa = simd::select(linear, wa, sa * inverseSin);
+    wb = simd::select(linear, wb, sb * inverseSin);
+  }
+  rx = simd::fma(wa, ax, wb * bx);
+  ry = simd::fma(wa, ay, wb * by);
+  rz = simd::fma(wa, az, wb * bz);
+  rw = simd::fma(wa, aw, wb * bw);
+  auto inverseLength = V(1) / sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+  rx = rx * inverseLength;
+  ry = ry * inverseLength;
+  rz = rz * inverseLength;
+  rw = rw * inverseLength;
+}
+
+template <class V>
+void storeRotationMatrixLanes(const V x, const V y, const V z, const V w, float* elements) {
+  auto two = V(2);
+  auto xy2 = two * x * y;
+  auto xz2 = two * x * z;
+  auto xw2 = two * x * w;
+  auto yz2 = two * y * z;
+  auto yw2 = two * y * w;
+  auto zw2 = two * z * w;
+  auto ww2 = two * w * w;
+  auto one = V(1);
+  V m[] = {
+    ww2 + two * x * x - one, xy2 + zw2, xz2 - yw2,
+    xy2 - zw2, ww2 + two * y * y - one, yz2 + xw2,
+    xz2 + yw2, yz2 - xw2, ww2 + two * z * z - one
+  };
+  for (size_t i = 0; i < 9; i++) {
+    m[i].storeStrided(elements + i, 9);
+  }
+}
+
+// Writes quaternions to rx/ry/rz/rw, or rotation matrices to elements when it is not null.
+template <class V>
+void interpolateBatch(const float* ax, const float* ay, const float* az, const float* aw,
+    const float* bx, const float* by, const float* bz, const float* bw, const float* t, size_t count, bool spherical,
+    float* rx, float* ry, float* rz, float* rw, float* elements) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V x, y, z, w;
+    interpolateLanes(V::load(ax + i), V::load(ay + i), V::load(az + i), V::load(aw + i),
+      V::load(bx + i), V::load(by + i), V::load(bz + i), V::load(bw + i), V::load(t + i), spherical, x, y, z, w);
+    if (elements) {
+      storeRotationMatrixLanes(x, y, z, w, elements + 9 * i);
+    } else {
+      x.store(rx + i);
+      y.store(ry + i);
+      z.store(rz + i);
+      w.store(rw + i);
+    }
+  }
+  for (; i < count; i++) {
+    simd::Float1 x, y, z, w;
+    interpolateLanes<simd::Float1>(ax[i], ay[i], az[i], aw[i], bx[i], by[i], bz[i], bw[i], t[i], spherical, x, y, z, w);
+    if (elements) {
+      storeRotationMatrixLanes(x, y, z, w, elements + 9 * i);
+    } else {
+      rx[i] = x.v;
+      ry[i] = y.v;
+      rz[i] = z.v;
+      rw[i] = w.v;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef __ORTHONORMALIZATION_H__
+#define __ORTHONORMALIZATION_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "./RotationMatrix.h"
+#include "./simd.h"
+
+// Newton steps of the polar mode; enough for float precision from a drift of up to about 0.1.
+const size_t ORTHONORMALIZATION_POLAR_ITERATIONS = 3;
+
+#define SIMD_KERNELS "./orthonormalizationKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// GramSchmidt keeps the direction of the first column and is the cheaper one; Polar returns the nearest rotation,
+// spreading the correction over all three columns, with the Newton iteration X = (X + X^-T) / 2.
+enum class Orthonormalization {
+  GramSchmidt,
+  Polar
+};
+
+// Largest deviation of a dot product between two columns from the identity, 0 for an exact rotation.
+// toQuaternion and toEulerAngle of a matrix are off by roughly this much.
+template <typename T>
+T orthonormalityDrift(const BasicRotationMatrix<T>& m) {
+  const auto& e = m.elements;
+  T products[] = {
+    e[0] * e[0] + e[1] * e[1] + e[2] * e[2] - 1,
+    e[3] * e[3] + e[4] * e[4] + e[5] * e[5] - 1,
+    e[6] * e[6] + e[7] * e[7] + e[8] * e[8] - 1,
+    e[0] * e[3] + e[1] * e[4] + e[2] * e[5],
+    e[0] * e[6] + e[1] * e[7] + e[2] * e[8],
+    e[3] * e[6] + e[4] * e[7] + e[5] * e[8]
+  };
+  T drift = 0;
+  for (auto p : products) {
+    drift = std::max(drift, std::abs(p));
+  }
+  return drift;
+}
+
+template <typename T>
+BasicRotationMatrix<T> orthonormalize(const BasicRotationMatrix<T>& m, Orthonormalization mode = Orthonormalization::Polar) {
+  auto e = m.elements;
+  auto cross = [&](size_t a, size_t b, T* r) {
+    r[0] = e[a + 1] * e[b + 2] - e[a + 2] * e[b + 1];
+    r[1] = e[a + 2] * e[b] - e[a] * e[b + 2];
+    r[2] = e[a] * e[b + 1] - e[a + 1] * e[b];
+  };
+  if (mode == Orthonormalization::Polar) {
+    for (size_t k = 0; k < ORTHONORMALIZATION_POLAR_ITERATIONS; k++) {
+      // Columns of the cofactor matrix, det(X) X^-T.
+      T c[9];
+      cross(3, 6, c);
+      cross(6, 0, c + 3);
+      cross(0, 3, c + 6);
+      auto h = T(0.5) / (e[0] * c[0] + e[1] * c[1] + e[2] * c[2]);
+      for (size_t i = 0; i < 9; i++) {
+        e[i] = T(0.5) * e[i] + h * c[i];
+      }
+    }
+    return BasicRotationMatrix<T>(e);
+  }
+  auto inverseLength = 1 / std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]);
+  for (size_t i = 0; i < 3; i++) {
+    e[i] *= inverseLength;
+  }
+  auto d = e[0] * e[3] + e[1] * e[4] + e[2] * e[5];
+  for (size_t i = 0; i < 3; i++) {
+    e[3 + i] -= d * e[i];
+  }
+  inverseLength = 1 / std::sqrt(e[3] * e[3] + e[4] * e[4] + e[5] * e[5]);
+  for (size_t i = 3; i < 6; i++) {
+    e[i] *= inverseLength;
+  }
+  T third[3];
+  cross(0, 3, third);
+  for (size_t i = 0; i < 3; i++) {
+    e[6 + i] = third[i];
+  }
+  return BasicRotationMatrix<T>(e);
+}
+
+// Orthonormalizes count matrices in one SIMD pass, writing the drift of each input matrix to drift when it is not
+// null. result may be matrices itself.
+void orthonormalizeBatch(Orthonormalization mode, const RotationMatrix* matrices, size_t count, RotationMatrix* result,
+    float* drift = nullptr) {
+  static_assert(sizeof(RotationMatrix) == 9 * sizeof(float), "rotation matrices must be packed.");
+  if (count == 0) {
+    return;
+  }
+  SIMD_DISPATCH(orthonormalizeBatch, matrices->elements.data(), count, mode == Orthonormalization::Polar,
+    result->elements.data(), drift);
+}
+
+// Only measures the drift, e.g. to orthonormalize once it exceeds a threshold rather than every frame.
+void orthonormalityDriftBatch(const RotationMatrix* matrices, size_t count, float* drift) {
+  if (count == 0) {
+    return;
+  }
+  SIMD_DISPATCH(orthonormalizeBatch, matrices->elements.data(), count, false, nullptr, drift);
+}
+
+#endif // __ORTHONORMALIZATION_H__
@@ -0,0 +1,83 @@
+// Lane-generic kernels behind orthonormalization.h, included once per SIMD target through simdTargets.h.
+
+template <class V>
+void crossLanes(const V ax, const V ay, const V az, const V bx, const V by, const V bz, V& rx, V& ry, V& rz) {
+  rx = ay * bz - az * by;
+  ry = az * bx - ax * bz;
+  rz = ax * by - ay * bx;
+}
+
+// Same as orthonormalityDrift on the nine elements of each lane.
+template <class V>
+V driftLanes(const V* m) {
+  auto one = V(1);
+  auto d = abs(m[0] * m[0] + m[1] * m[1] + m[2] * m[2] - one);
+  d = max(d, abs(m[3] * m[3] + m[4] * m[4] + m[5] * m[5] - one));
+  d = max(d, abs(m[6] * m[6] + m[7] * m[7] + m[8] * m[8] - one));
+  d = max(d, abs(m[0] * m[3] + m[1] * m[4] + m[2] * m[5]));
+  d = max(d, abs(m[0] * m[6] + m[1] * m[7] + m[2] * m[8]));
+  return max(d, abs(m[3] * m[6] + m[4] * m[7] + m[5] * m[8]));
+}
+
+// Same arithmetic as orthonormalize.
+template <class V>
+void orthonormalizeLanes(V* m, bool polar) {
+  if (polar) {
+    for (size_t k = 0; k < ORTHONORMALIZATION_POLAR_ITERATIONS; k++) {
+      V c[9];
+      crossLanes(m[3], m[4], m[5], m[6], m[7], m[8], c[0], c[1], c[2]);
+      crossLanes(m[6], m[7], m[8], m[0], m[1], m[2], c[3], c[4], c[5]);
+      crossLanes(m[0], m[1], m[2], m[3], m[4], m[5], c[6], c[7], c[8]);
+      auto half = V(0.5f);
+      auto h = half / (m[0] * c[0] + m[1] * c[1] + m[2] * c[2]);
+      for (size_t i = 0; i < 9; i++) {
+        m[i] = simd::fma(half, m[i], h * c[i]);
+      }
+    }
+    return;
+  }
+  auto inverseLength = V(1) / sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+  m[0] = m[0] * inverseLength;
+  m[1] = m[1] * inverseLength;
+  m[2] = m[2] * inverseLength;
+  auto d = m[0] * m[3] + m[1] * m[4] + m[2] * m[5];
+  m[3] = m[3] - d * m[0];
+  m[4] = m[4] - d * m[1];
+  m[5] = m[5] - d * m[2];
+  inverseLength = V(1) / sqrt(m[3] * m[3] + m[4] * m[4] + m[5] * m[5]);
+  m[3] = m[3] * inverseLength;
+  m[4] = m[4] * inverseLength;
+  m[5] = m[5] * inverseLength;
+  crossLanes(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]);
+}
+
+template <class V>
+void orthonormalizeGroup(const float* elements, bool polar, float* result, float* drift) {
+  V m[9];
+  for (size_t i = 0; i < 9; i++) {
+    m[i] = V::loadStrided(elements + i, 9);
+  }
+  if (drift) {
+    driftLanes(m).store(drift);
+  }
+  if (result) {
+    orthonormalizeLanes(m, polar);
+    for (size_t i = 0; i < 9; i++) {
+      m[i].storeStrided(result + i, 9);
+    }
+  }
+}
+
+// Matrices are packed as RotationMatrix::elements. Skips the correction when result is null and the drift when drift
+// is null.
+template <class V>
+void orthonormalizeBatch(const float* elements, size_t count, bool polar, float* result, float* drift) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    orthonormalizeGroup<V>(elements + 9 * i, polar, result ? result + 9 * i : nullptr, drift ? drift + i : nullptr);
+  }
+  for (; i < count; i++) {
+    orthonormalizeGroup<simd::Float1>(elements + 9 * i, polar, result ? result + 9 * i : nullptr,
+      drift ? drift + i : nullptr);
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef __PARALLELCONVERSION_H__
+#define __PARALLELCONVERSION_H__
+
+#include <cstddef>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./ThreadPool.h"
+#include "./batchConversion.h"
+#include "./conversion.h"
+
+// Chunks are sized so that the input and output of one chunk fit comfortably in a core's L2 cache.
+const size_t PARALLEL_CHUNK_BYTES = 128 * 1024;
+
+// Number of elements per chunk for elements touching bytesPerElement bytes, kept a multiple of the widest SIMD lane.
+size_t parallelChunkSize(size_t bytesPerElement) {
+  auto size = PARALLEL_CHUNK_BYTES / bytesPerElement;
+  return size < 16 ? 16 : size - size % 16;
+}
+
+// Every element is written to the same index it is read from, so the result does not depend on the thread count
+// or on which worker converted which chunk.
+template <typename T, typename R, typename F>
+void parallelConvert(ThreadPool& pool, const T* input, size_t count, R* result, F convert) {
+  pool.parallelFor(count, parallelChunkSize(sizeof(T) + sizeof(R)), [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; i++) {
+      result[i] = convert(input[i]);
+    }
+  });
+}
+
+template <typename T>
+void toEulerAngle(ThreadPool& pool, const BasicQuaternion<T>* q, size_t count, EulerOrder order, BasicEulerAngle<T>* result) {
+  parallelConvert(pool, q, count, result, [order](const BasicQuaternion<T>& q) { return toEulerAngle(q, order); });
+}
+
+template <typename T>
+void toEulerAngle(ThreadPool& pool, const BasicRotationMatrix<T>* m, size_t count, EulerOrder order, BasicEulerAngle<T>* result) {
+  parallelConvert(pool, m, count, result, [order](const BasicRotationMatrix<T>& m) { return toEulerAngle(m, order); });
+}
+
+template <typename T>
+void toQuaternion(ThreadPool& pool, const BasicEulerAngle<T>* e, size_t count, BasicQuaternion<T>* result) {
+  parallelConvert(pool, e, count, result, [](const BasicEulerAngle<T>& e) { return toQuaternion(e); });
+}
+
+template <typename T>
+void toQuaternion(ThreadPool& pool, const BasicRotationMatrix<T>* m, size_t count, BasicQuaternion<T>* result) {
+  parallelConvert(pool, m, count, result, [](const BasicRotationMatrix<T>& m) { return toQuaternion(m); });
+}
+
+template <typename T>
+void toRotationMatrix(ThreadPool& pool, const BasicEulerAngle<T>* e, size_t count, BasicRotationMatrix<T>* result) {
+  parallelConvert(pool, e, count, result, [](const BasicEulerAngle<T>& e) { return toRotationMatrix(e); });
+}
+
+template <typename T>
+void toRotationMatrix(ThreadPool& pool, const BasicQuaternion<T>* q, size_t count, BasicRotationMatrix<T>* result) {
+  parallelConvert(pool, q, count, result, [](const BasicQuaternion<T>& q) { return toRotationMatrix(q); });
+}
+
+// Parallel versions of the SIMD batch conversions; each chunk runs the single-threaded batch function.
+void toEulerAngleBatch(ThreadPool& pool, const float* x, const float* y, const float* z, const float* w, size_t count,
+    EulerOrder order, float* ex, float* ey, float* ez) {
+  pool.parallelFor(count, parallelChunkSize(7 * sizeof(float)), [&](size_t begin, size_t end) {
+    toEulerAngleBatch(x + begin, y + begin, z + begin, w + begin, end - begin, order, ex + begin, ey + begin, ez + begin);
+  });
+}
+
+void toQuaternionBatch(ThreadPool& pool, const float* elements, size_t count, float* x, float* y, float* z, float* w) {
+  pool.parallelFor(count, parallelChunkSize(13 * sizeof(float)), [&](size_t begin, size_t end) {
+    toQuaternionBatch(elements + 9 * begin, end - begin, x + begin, y + begin, z + begin, w + begin);
+  });
+}
+
+void toRotationMatrixBatch(ThreadPool& pool, const float* x, const float* y, const float* z, size_t count, EulerOrder order,
+    float* elements) {
+  pool.parallelFor(count, parallelChunkSize(12 * sizeof(float)), [&](size_t begin, size_t end) {
+    toRotationMatrixBatch(x + begin, y + begin, z + begin, end - begin, order, elements + 9 * begin);
+  });
+}
+
+#endif // __PARALLELCONVERSION_H__
@@ -0,0 +1,97 @@
+// Lane-generic kernels behind QuaternionCodec.h, included once per SIMD target through simdTargets.h.
+
+// Normalizes q, flips it so that its largest component is positive and returns the index of that component with the
+// other three, in x, y, z, w order, quantized to [0, levels].
+template <class V>
+void quantizeSmallestThreeLanes(V x, V y, V z, V w, const V levels, V& index, V& a, V& b, V& c) {
+  auto scale = V(1) / simd::sqrt(x * x + y * y + z * z + w * w);
+  index = V(0);
+  auto largest = x;
+  auto magnitude = simd::abs(x);
+  auto m = simd::abs(y) > magnitude;
+  index = simd::select(m, V(1), index);
+  largest = simd::select(m, y, largest);
+  magnitude = simd::max(magnitude, simd::abs(y));
+  m = simd::abs(z) > magnitude;
+  index = simd::select(m, V(2), index);
+  largest = simd::select(m, z, largest);
+  magnitude = simd::max(magnitude, simd::abs(z));
+  m = simd::abs(w) > magnitude;
+  index = simd::select(m, V(3), index);
+  largest = simd::select(m, w, largest);
+  scale = simd::copySign(scale, largest);
+  auto first = index < V(0.5f);
+  auto second = index < V(1.5f);
+  auto third = index < V(2.5f);
+  a = simd::select(first, y, x);
+  b = simd::select(second, z, y);
+  c = simd::select(third, w, z);
+  // Components other than the largest lie in [-1/sqrt(2), 1/sqrt(2)].
+  auto step = levels * V(0.5f * SQRT_TWO);
+  auto offset = V(0.5f) * levels + V(0.5f);
+  a = simd::min(simd::max(simd::floor(a * scale * step + offset), V(0)), levels);
+  b = simd::min(simd::max(simd::floor(b * scale * step + offset), V(0)), levels);
+  c = simd::min(simd::max(simd::floor(c * scale * step + offset), V(0)), levels);
+}
+
+template <class V>
+void dequantizeSmallestThreeLanes(const V index, V a, V b, V c, const V levels, V& x, V& y, V& z, V& w) {
+  auto step = V(SQRT_TWO) / levels;
+  auto offset = V(0.5f * SQRT_TWO);
+  a = a * step - offset;
+  b = b * step - offset;
+  c = c * step - offset;
+  auto largest = simd::sqrt(simd::max(V(1) - a * a - b * b - c * c, V(0)));
+  auto first = index < V(0.5f);
+  auto second = index < V(1.5f);
+  auto third = index < V(2.5f);
+  x = simd::select(first, largest, a);
+  y = simd::select(first, a, simd::select(second, largest, b));
+  z = simd::select(second, b, simd::select(third, largest, c));
+  w = simd::select(third, c, largest);
+}
+
+template <class V>
+void quantizeSmallestThreeBatch(const float* x, const float* y, const float* z, const float* w, size_t count,
+    float levels, float* index, float* a, float* b, float* c) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V vi, va, vb, vc;
+    quantizeSmallestThreeLanes(V::load(x + i), V::load(y + i), V::load(z + i), V::load(w + i), V(levels), vi, va, vb, vc);
+    vi.store(index + i);
+    va.store(a + i);
+    vb.store(b + i);
+    vc.store(c + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 vi, va, vb, vc;
+    quantizeSmallestThreeLanes<simd::Float1>(x[i], y[i], z[i], w[i], levels, vi, va, vb, vc);
+    index[i] = vi.v;
+    a[i] = va.v;
+    b[i] = vb.v;
+    c[i] = vc.v;
+  }
+}
+
+template <class V>
+void dequantizeSmallestThreeBatch(const float* index, const float* a, const float* b, const float* c, size_t count,
+    float levels, float* x, float* y, float* z, float* w) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    V vx, vy, vz, vw;
+    dequantizeSmallestThreeLanes(V::load(index + i), V::load(a + i), V::load(b + i), V::load(c + i), V(levels),
+      vx, vy, vz, vw);
+    vx.store(x + i);
+    vy.store(y + i);
+    vz.store(z + i);
+    vw.store(w + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 vx, vy, vz, vw;
+    dequantizeSmallestThreeLanes<simd::Float1>(index[i], a[i], b[i], c[i], levels, vx, vy, vz, vw);
+    x[i] = vx.v;
+    y[i] = vy.v;
+    z[i] = vz.v;
+    w[i] = vw.v;
+  }
+}
@@ -0,0 +1,31 @@
+#ifndef __QUATERNIONNORMALIZATION_H__
+#define __QUATERNIONNORMALIZATION_H__
+
+#include <cstddef>
+
+#include "./Quaternion.h"
+#include "./simd.h"
+
+#define SIMD_KERNELS "./quaternionNormalizationKernels.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+// Normalizes count quaternions stored as separate x/y/z/w arrays, within a few ulps of normalize of Quaternion.h.
+// With canonical, the default, the results are also canonicalized to w >= 0 in the same pass at no extra cost.
+// Zero quaternions give NaN. The outputs may alias the inputs.
+void normalizeBatch(const float* x, const float* y, const float* z, const float* w, size_t count,
+    float* rx, float* ry, float* rz, float* rw, bool canonical = true) {
+  SIMD_DISPATCH(normalizeBatch, x, y, z, w, count, canonical, rx, ry, rz, rw);
+}
+
+// Same for packed quaternions, several times slower than separate arrays for the deinterleaving; result may be
+// quaternions itself.
+void normalizeBatch(const Quaternion* quaternions, size_t count, Quaternion* result, bool canonical = true) {
+  static_assert(sizeof(Quaternion) == 4 * sizeof(float), "quaternions must be packed.");
+  if (count == 0) {
+    return;
+  }
+  SIMD_DISPATCH(normalizeInterleavedBatch, &quaternions->x, count, canonical, &result->x);
+}
+
+#endif // __QUATERNIONNORMALIZATION_H__
@@ -0,0 +1,66 @@
+// Lane-generic kernels behind quaternionNormalization.h, included once per SIMD target through simdTargets.h.
+
+// Scales to unit length with the rsqrt estimate refined by one Newton step, r * (1.5 - 0.5 * n * r * r), which
+// leaves a relative error of a few float ulps. With canonical, the scale takes the sign of w so that w >= 0.
+template <class V>
+void normalizeLanes(V& x, V& y, V& z, V& w, bool canonical) {
+  auto n = x * x + y * y + z * z + w * w;
+  auto r = rsqrtEstimate(n);
+  r = r * simd::fma(V(-0.5f) * n, r * r, V(1.5f));
+  if (canonical) {
+    r = copySign(r, w);
+  }
+  x = x * r;
+  y = y * r;
+  z = z * r;
+  w = w * r;
+}
+
+template <class V>
+void normalizeBatch(const float* x, const float* y, const float* z, const float* w, size_t count, bool canonical,
+    float* rx, float* ry, float* rz, float* rw) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    auto qx = V::load(x + i), qy = V::load(y + i), qz = V::load(z + i), qw = V::load(w + i);
+    normalizeLanes(qx, qy, qz, qw, canonical);
+    qx.store(rx + i);
+    qy.store(ry + i);
+    qz.store(rz + i);
+    qw.store(rw + i);
+  }
+  for (; i < count; i++) {
+    simd::Float1 qx(x[i]), qy(y[i]), qz(z[i]), qw(w[i]);
+    normalizeLanes(qx, qy, qz, qw, canonical);
+    rx[i] = qx.v;
+    ry[i] = qy.v;
+    rz[i] = qz.v;
+    rw[i] = qw.v;
+  }
+}
+
+// Same for quaternions packed as xyzw.
+template <class V>
+void normalizeInterleavedBatch(const float* xyzw, size_t count, bool canonical, float* result) {
+  size_t i = 0;
+  for (; i + V::width <= count; i += V::width) {
+    auto p = xyzw + 4 * i;
+    auto qx = V::loadStrided(p, 4), qy = V::loadStrided(p + 1, 4), qz = V::loadStrided(p + 2, 4);
+    auto qw = V::loadStrided(p + 3, 4);
+    normalizeLanes(qx, qy, qz, qw, canonical);
+    auto r = result + 4 * i;
+    qx.storeStrided(r, 4);
+    qy.storeStrided(r + 1, 4);
+    qz.storeStrided(r + 2, 4);
+    qw.storeStrided(r + 3, 4);
+  }
+  for (; i < count; i++) {
+    auto p = xyzw + 4 * i;
+    simd::Float1 qx(p[0]), qy(p[1]), qz(p[2]), qw(p[3]);
+    normalizeLanes(qx, qy, qz, qw, canonical);
+    auto r = result + 4 * i;
+    r[0] = qx.v;
+    r[1] = qy.v;
+    r[2] = qz.v;
+    r[3] = qw.v;
+  }
+}
@@ -0,0 +1,115 @@
+#ifndef __ROTATIONFILECONVERSION_H__
+#define __ROTATIONFILECONVERSION_H__
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationFile.h"
+#include "./RotationMatrix.h"
+#include "./ThreadPool.h"
+#include "./conversion.h"
+#include "./parallelConversion.h"
+
+// Converts records straight from the input mapping into a pre-sized output mapping, sharded into cache-sized chunks
+// across the pool, so nothing is copied besides the conversion itself. The input record type is checked before the
+// output is created.
+template <class From, class To, typename F>
+void convertRotationRecords(ThreadPool& pool, const RotationFile& input, const char* output, F convert) {
+  auto count = input.header().count;
+  auto source = input.records<From>();
+  auto file = createRotationFile<To>(output, count);
+  auto records = reinterpret_cast<To*>(file->data() + ROTATION_FILE_DATA_OFFSET);
+  pool.parallelFor(count, parallelChunkSize(sizeof(From) + sizeof(To)), [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; i++) {
+      storeRotationRecord(records + i, convert(source[i]));
+    }
+  });
+  file->sync();
+}
+
+template <typename T>
+void convertRotationFile(ThreadPool& pool, const RotationFile& input, const char* output, RotationKind to, EulerOrder order) {
+  using E = BasicEulerAngle<T>;
+  using Q = BasicQuaternion<T>;
+  using M = BasicRotationMatrix<T>;
+  switch (input.header().kind) {
+  case RotationKind::EulerAngle:
+    switch (to) {
+    case RotationKind::EulerAngle:
+      return convertRotationRecords<E, E>(pool, input, output, [order](const E& e) {
+        return e.order == order ? e : toEulerAngle(toRotationMatrix(e), order);
+      });
+    case RotationKind::Quaternion:
+      return convertRotationRecords<E, Q>(pool, input, output, [](const E& e) { return toQuaternion(e); });
+    case RotationKind::RotationMatrix:
+      return convertRotationRecords<E, M>(pool, input, output, [](const E& e) { return toRotationMatrix(e); });
+    }
+    break;
+  case RotationKind::Quaternion:
+    switch (to) {
+    case RotationKind::EulerAngle:
+      return convertRotationRecords<Q, E>(pool, input, output, [order](const Q& q) { return toEulerAngle(q, order); });
+    case RotationKind::Quaternion:
+      return convertRotationRecords<Q, Q>(pool, input, output, [](const Q& q) { return q; });
+    case RotationKind::RotationMatrix:
+      return convertRotationRecords<Q, M>(pool, input, output, [](const Q& q) { return toRotationMatrix(q); });
+    }
+    break;
+  case RotationKind::RotationMatrix:
+    switch (to) {
+    case RotationKind::EulerAngle:
+      return convertRotationRecords<M, E>(pool, input, output, [order](const M& m) { return toEulerAngle(m, order); });
+    case RotationKind::Quaternion:
+      return convertRotationRecords<M, Q>(pool, input, output, [](const M& m) { return toQuaternion(m); });
+    case RotationKind::RotationMatrix:
+      return convertRotationRecords<M, M>(pool, input, output, [](const M& m) { return m; });
+    }
+    break;
+  }
+  throw "conversion of rotation file is failed.";
+}
+
+// Converts the rotation file at input into a rotation file of kind to at output, keeping the scalar type. order is
+// the euler order of the output when to is RotationKind::EulerAngle. The output is written to a new temporary file
+// next to it, synced and renamed into place, so a failed conversion leaves an existing output untouched; output must
+// not be the input.
+void convertRotationFile(ThreadPool& pool, const char* input, const char* output, RotationKind to,
+    EulerOrder order = EulerOrder::XYZ) {
+  RotationFile file(input);
+  if (isSameFile(input, output)) {
+    throw "output of rotation file is the input.";
+  }
+  auto temporary = std::string(output) + ".XXXXXX";
+  auto fd = mkstemp(temporary.data());
+  if (fd < 0) {
+    throw "creation of rotation file is failed.";
+  }
+  try {
+    if (isSameFile(input, temporary.c_str()) || fchmod(fd, 0644) != 0) {
+      throw "creation of rotation file is failed.";
+    }
+    switch (file.header().scalarSize) {
+    case sizeof(float):
+      convertRotationFile<float>(pool, file, temporary.c_str(), to, order);
+      break;
+    case sizeof(double):
+      convertRotationFile<double>(pool, file, temporary.c_str(), to, order);
+      break;
+    default:
+      throw "conversion of rotation file is failed.";
+    }
+    if (fsync(fd) != 0 || rename(temporary.c_str(), output) != 0) {
+      throw "creation of rotation file is failed.";
+    }
+  } catch (...) {
+    close(fd);
+    unlink(temporary.c_str());
+    throw;
+  }
+  close(fd);
+}
+
+#endif // __ROTATIONFILECONVERSION_H__
@@ -0,0 +1,468 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "./Half.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+namespace simd {
+
+const float PI = 3.14159265359f;
+const float HALF_PI = 0.5f * PI;
+const float QUARTER_PI = 0.25f * PI;
+const float SQRT_TWO = 1.41421356237f;
+
+enum class Tier {
+  Scalar,
+  Sse41,
+  Avx2,
+  Avx512
+};
+
+Tier supportedTier() {
+#if SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("f16c")) {
+    return Tier::Avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c")) {
+    return Tier::Avx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return Tier::Sse41;
+  }
+#endif
+  return Tier::Scalar;
+}
+
+Tier clampTier(Tier tier) {
+  auto supported = supportedTier();
+  return tier < supported ? tier : supported;
+}
+
+// Tier named scalar, sse4.1, avx2 or avx512, clamped to supportedTier(). Unknown names throw, so that a forced-tier
+// debugging run cannot silently test other kernels than intended.
+Tier parseTier(const char* name) {
+  if (std::strcmp(name, "scalar") == 0) {
+    return Tier::Scalar;
+  } else if (std::strcmp(name, "sse4.1") == 0) {
+    return clampTier(Tier::Sse41);
+  } else if (std::strcmp(name, "avx2") == 0) {
+    return clampTier(Tier::Avx2);
+  } else if (std::strcmp(name, "avx512") == 0) {
+    return clampTier(Tier::Avx512);
+  }
+  throw "simd tier is unknown.";
+}
+
+// ROTATION_SIMD_TIER=scalar|sse4.1|avx2|avx512 forces a lower tier for debugging. The tier is atomic, so setTier
+// may be called while other threads dispatch; each dispatch runs either the old or the new tier.
+std::atomic<Tier>& activeTier() {
+  static std::atomic<Tier> tier([] {
+    auto forced = std::getenv("ROTATION_SIMD_TIER");
+    return forced == nullptr ? supportedTier() : parseTier(forced);
+  }());
+  return tier;
+}
+
+Tier tier() {
+  return activeTier().load(std::memory_order_relaxed);
+}
+
+void setTier(Tier tier) {
+  activeTier().store(clampTier(tier), std::memory_order_relaxed);
+}
+
+class Mask1 {
+public:
+  bool v;
+  Mask1(bool v): v(v) {}
+};
+
+class Float1 {
+public:
+  static const size_t width = 1;
+  using Mask = Mask1;
+  float v;
+  Float1() {}
+  Float1(float v): v(v) {}
+  static Float1 load(const float* p) { return Float1(*p); }
+  static Float1 loadStrided(const float* p, size_t) { return Float1(*p); }
+  static void loadInterleaved3(const float* p, Float1& x, Float1& y, Float1& z) {
+    x = Float1(p[0]);
+    y = Float1(p[1]);
+    z = Float1(p[2]);
+  }
+  void store(float* p) const { *p = v; }
+  void storeStrided(float* p, size_t) const { *p = v; }
+  static void storeInterleaved3(float* p, const Float1 x, const Float1 y, const Float1 z) {
+    p[0] = x.v;
+    p[1] = y.v;
+    p[2] = z.v;
+  }
+  static Float1 loadHalf(const uint16_t* p) { return Float1(halfBitsToFloat(*p)); }
+  void storeHalf(uint16_t* p) const { *p = floatToHalfBits(v); }
+};
+
+Float1 operator+(const Float1 a, const Float1 b) { return Float1(a.v + b.v); }
+Float1 operator-(const Float1 a, const Float1 b) { return Float1(a.v - b.v); }
+Float1 operator*(const Float1 a, const Float1 b) { return Float1(a.v * b.v); }
+Float1 operator/(const Float1 a, const Float1 b) { return Float1(a.v / b.v); }
+Float1 operator-(const Float1 a) { return Float1(-a.v); }
+Mask1 operator<(const Float1 a, const Float1 b) { return Mask1(a.v < b.v); }
+Mask1 operator>(const Float1 a, const Float1 b) { return Mask1(a.v > b.v); }
+Mask1 operator&(const Mask1 a, const Mask1 b) { return Mask1(a.v && b.v); }
+Mask1 operator|(const Mask1 a, const Mask1 b) { return Mask1(a.v || b.v); }
+Float1 abs(const Float1 a) { return Float1(std::abs(a.v)); }
+Float1 min(const Float1 a, const Float1 b) { return Float1(a.v < b.v ? a.v : b.v); }
+Float1 max(const Float1 a, const Float1 b) { return Float1(a.v > b.v ? a.v : b.v); }
+Float1 sqrt(const Float1 a) { return Float1(std::sqrt(a.v)); }
+// Approximate 1 / sqrt(a) from the hardware estimate: about 12 bits, 14 with AVX-512.
+#if SIMD_X86
+Float1 rsqrtEstimate(const Float1 a) { return Float1(_mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(a.v)))); }
+#else
+Float1 rsqrtEstimate(const Float1 a) { return Float1(1 / std::sqrt(a.v)); }
+#endif
+Float1 floor(const Float1 a) { return Float1(std::floor(a.v)); }
+Float1 copySign(const Float1 magnitude, const Float1 sign) { return Float1(std::copysign(magnitude.v, sign.v)); }
+Float1 select(const Mask1 m, const Float1 a, const Float1 b) { return m.v ? a : b; }
+Float1 fma(const Float1 a, const Float1 b, const Float1 c) { return Float1(a.v * b.v + c.v); }
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+class Mask4 {
+public:
+  __m128 v;
+  Mask4(__m128 v): v(v) {}
+};
+
+class Float4 {
+public:
+  static const size_t width = 4;
+  using Mask = Mask4;
+  __m128 v;
+  Float4() {}
+  Float4(__m128 v): v(v) {}
+  Float4(float s): v(_mm_set1_ps(s)) {}
+  static Float4 load(const float* p) { return Float4(_mm_loadu_ps(p)); }
+  static Float4 loadStrided(const float* p, size_t stride) {
+    return Float4(_mm_setr_ps(p[0], p[stride], p[2 * stride], p[3 * stride]));
+  }
+  // Splits width xyz triples into one register per component, and back, with blends and in-register shuffles:
+  // a = x0 y0 z0 x1, b = y1 z1 x2 y2 and c = z2 x3 y3 z3 are blended into x0 x3 x2 x1, y1 y0 y3 y2 and z2 z1 z0 z3.
+  static void deinterleave3(__m128 a, __m128 b, __m128 c, __m128& x, __m128& y, __m128& z) {
+    auto xx = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);
+    x = _mm_shuffle_ps(xx, xx, _MM_SHUFFLE(1, 2, 3, 0));
+    auto yy = _mm_blend_ps(_mm_blend_ps(a, b, 0x9), c, 0x4);
+    y = _mm_shuffle_ps(yy, yy, _MM_SHUFFLE(2, 3, 0, 1));
+    auto zz = _mm_blend_ps(_mm_blend_ps(a, b, 0x2), c, 0x9);
+    z = _mm_shuffle_ps(zz, zz, _MM_SHUFFLE(3, 0, 1, 2));
+  }
+  static void interleave3(__m128 x, __m128 y, __m128 z, __m128& a, __m128& b, __m128& c) {
+    x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 2, 3, 0));
+    y = _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 3, 0, 1));
+    z = _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 0, 1, 2));
+    a = _mm_blend_ps(_mm_blend_ps(x, y, 0x2), z, 0x4);
+    b = _mm_blend_ps(_mm_blend_ps(y, z, 0x2), x, 0x4);
+    c = _mm_blend_ps(_mm_blend_ps(z, x, 0x2), y, 0x4);
+  }
+  static void loadInterleaved3(const float* p, Float4& x, Float4& y, Float4& z) {
+    deinterleave3(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), x.v, y.v, z.v);
+  }
+  static void storeInterleaved3(float* p, const Float4 x, const Float4 y, const Float4 z) {
+    __m128 a, b, c;
+    interleave3(x.v, y.v, z.v, a, b, c);
+    _mm_storeu_ps(p, a);
+    _mm_storeu_ps(p + 4, b);
+    _mm_storeu_ps(p + 8, c);
+  }
+  void store(float* p) const { _mm_storeu_ps(p, v); }
+  void storeStrided(float* p, size_t stride) const {
+    float lanes[width];
+    store(lanes);
+    for (size_t i = 0; i < width; i++) {
+      p[i * stride] = lanes[i];
+    }
+  }
+  static Float4 loadHalf(const uint16_t* p) {
+    return Float4(_mm_setr_ps(halfBitsToFloat(p[0]), halfBitsToFloat(p[1]), halfBitsToFloat(p[2]), halfBitsToFloat(p[3])));
+  }
+  void storeHalf(uint16_t* p) const {
+    float lanes[width];
+    store(lanes);
+    for (size_t i = 0; i < width; i++) {
+      p[i] = floatToHalfBits(lanes[i]);
+    }
+  }
+};
+
+Float4 operator+(const Float4 a, const Float4 b) { return Float4(_mm_add_ps(a.v, b.v)); }
+Float4 operator-(const Float4 a, const Float4 b) { return Float4(_mm_sub_ps(a.v, b.v)); }
+Float4 operator*(const Float4 a, const Float4 b) { return Float4(_mm_mul_ps(a.v, b.v)); }
+Float4 operator/(const Float4 a, const Float4 b) { return Float4(_mm_div_ps(a.v, b.v)); }
+Float4 operator-(const Float4 a) { return Float4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0f))); }
+Mask4 operator<(const Float4 a, const Float4 b) { return Mask4(_mm_cmplt_ps(a.v, b.v)); }
+Mask4 operator>(const Float4 a, const Float4 b) { return Mask4(_mm_cmpgt_ps(a.v, b.v)); }
+Mask4 operator&(const Mask4 a, const Mask4 b) { return Mask4(_mm_and_ps(a.v, b.v)); }
+Mask4 operator|(const Mask4 a, const Mask4 b) { return Mask4(_mm_or_ps(a.v, b.v)); }
+Float4 abs(const Float4 a) { return Float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+Float4 min(const Float4 a, const Float4 b) { return Float4(_mm_min_ps(a.v, b.v)); }
+Float4 max(const Float4 a, const Float4 b) { return Float4(_mm_max_ps(a.v, b.v)); }
+Float4 sqrt(const Float4 a) { return Float4(_mm_sqrt_ps(a.v)); }
+Float4 rsqrtEstimate(const Float4 a) { return Float4(_mm_rsqrt_ps(a.v)); }
+Float4 floor(const Float4 a) { return Float4(_mm_floor_ps(a.v)); }
+Float4 copySign(const Float4 magnitude, const Float4 sign) {
+  auto signBit = _mm_set1_ps(-0.0f);
+  return Float4(_mm_or_ps(_mm_andnot_ps(signBit, magnitude.v), _mm_and_ps(signBit, sign.v)));
+}
+Float4 select(const Mask4 m, const Float4 a, const Float4 b) { return Float4(_mm_blendv_ps(b.v, a.v, m.v)); }
+Float4 fma(const Float4 a, const Float4 b, const Float4 c) { return a * b + c; }
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+class Mask8 {
+public:
+  __m256 v;
+  Mask8(__m256 v): v(v) {}
+};
+
+class Float8 {
+public:
+  static const size_t width = 8;
+  using Mask = Mask8;
+  __m256 v;
+  Float8() {}
+  Float8(__m256 v): v(v) {}
+  Float8(float s): v(_mm256_set1_ps(s)) {}
+  static Float8 load(const float* p) { return Float8(_mm256_loadu_ps(p)); }
+  static Float8 loadStrided(const float* p, size_t stride) {
+    auto s = static_cast<int>(stride);
+    return Float8(_mm256_i32gather_ps(p, _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s), 4));
+  }
+  // Same blends and shuffles as Float4 on each 128-bit half, the halves holding triples 0-3 and 4-7.
+  static __m256 loadHalves(const float* low, const float* high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+  }
+  static void storeHalves(float* low, float* high, __m256 v) {
+    _mm_storeu_ps(low, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(v, 1));
+  }
+  static void loadInterleaved3(const float* p, Float8& x, Float8& y, Float8& z) {
+    auto a = loadHalves(p, p + 12), b = loadHalves(p + 4, p + 16), c = loadHalves(p + 8, p + 20);
+    x.v = _mm256_permute_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x44), c, 0x22), _MM_SHUFFLE(1, 2, 3, 0));
+    y.v = _mm256_permute_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x99), c, 0x44), _MM_SHUFFLE(2, 3, 0, 1));
+    z.v = _mm256_permute_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x22), c, 0x99), _MM_SHUFFLE(3, 0, 1, 2));
+  }
+  static void storeInterleaved3(float* p, const Float8 x, const Float8 y, const Float8 z) {
+    auto px = _mm256_permute_ps(x.v, _MM_SHUFFLE(1, 2, 3, 0));
+    auto py = _mm256_permute_ps(y.v, _MM_SHUFFLE(2, 3, 0, 1));
+    auto pz = _mm256_permute_ps(z.v, _MM_SHUFFLE(3, 0, 1, 2));
+    storeHalves(p, p + 12, _mm256_blend_ps(_mm256_blend_ps(px, py, 0x22), pz, 0x44));
+    storeHalves(p + 4, p + 16, _mm256_blend_ps(_mm256_blend_ps(py, pz, 0x22), px, 0x44));
+    storeHalves(p + 8, p + 20, _mm256_blend_ps(_mm256_blend_ps(pz, px, 0x22), py, 0x44));
+  }
+  void store(float* p) const { _mm256_storeu_ps(p, v); }
+  void storeStrided(float* p, size_t stride) const {
+    float lanes[width];
+    store(lanes);
+    for (size_t i = 0; i < width; i++) {
+      p[i * stride] = lanes[i];
+    }
+  }
+  static Float8 loadHalf(const uint16_t* p) {
+    return Float8(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+  }
+  void storeHalf(uint16_t* p) const {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+  }
+};
+
+Float8 operator+(const Float8 a, const Float8 b) { return Float8(_mm256_add_ps(a.v, b.v)); }
+Float8 operator-(const Float8 a, const Float8 b) { return Float8(_mm256_sub_ps(a.v, b.v)); }
+Float8 operator*(const Float8 a, const Float8 b) { return Float8(_mm256_mul_ps(a.v, b.v)); }
+Float8 operator/(const Float8 a, const Float8 b) { return Float8(_mm256_div_ps(a.v, b.v)); }
+Float8 operator-(const Float8 a) { return Float8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f))); }
+Mask8 operator<(const Float8 a, const Float8 b) { return Mask8(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+Mask8 operator>(const Float8 a, const Float8 b) { return Mask8(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)); }
+Mask8 operator&(const Mask8 a, const Mask8 b) { return Mask8(_mm256_and_ps(a.v, b.v)); }
+Mask8 operator|(const Mask8 a, const Mask8 b) { return Mask8(_mm256_or_ps(a.v, b.v)); }
+Float8 abs(const Float8 a) { return Float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)); }
+Float8 min(const Float8 a, const Float8 b) { return Float8(_mm256_min_ps(a.v, b.v)); }
+Float8 max(const Float8 a, const Float8 b) { return Float8(_mm256_max_ps(a.v, b.v)); }
+Float8 sqrt(const Float8 a) { return Float8(_mm256_sqrt_ps(a.v)); }
+Float8 rsqrtEstimate(const Float8 a) { return Float8(_mm256_rsqrt_ps(a.v)); }
+Float8 floor(const Float8 a) { return Float8(_mm256_floor_ps(a.v)); }
+Float8 copySign(const Float8 magnitude, const Float8 sign) {
+  auto signBit = _mm256_set1_ps(-0.0f);
+  return Float8(_mm256_or_ps(_mm256_andnot_ps(signBit, magnitude.v), _mm256_and_ps(signBit, sign.v)));
+}
+Float8 select(const Mask8 m, const Float8 a, const Float8 b) {
+  return Float8(_mm256_blendv_ps(b.v, a.v, m.v));
+}
+Float8 fma(const Float8 a, const Float8 b, const Float8 c) { return Float8(_mm256_fmadd_ps(a.v, b.v, c.v)); }
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma,f16c")
+// GCC 12 reports the _mm512_undefined_ps pass-through operand of the unmasked AVX-512 intrinsics as uninitialized
+// wherever they get inlined.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+class Mask16 {
+public:
+  __mmask16 v;
+  Mask16(__mmask16 v): v(v) {}
+};
+
+class Float16 {
+public:
+  static const size_t width = 16;
+  using Mask = Mask16;
+  __m512 v;
+  Float16() {}
+  Float16(__m512 v): v(v) {}
+  Float16(float s): v(_mm512_set1_ps(s)) {}
+  static __m512i strides(size_t stride) {
+    auto lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(stride)));
+  }
+  static Float16 load(const float* p) { return Float16(_mm512_loadu_ps(p)); }
+  static Float16 loadStrided(const float* p, size_t stride) { return Float16(_mm512_i32gather_ps(strides(stride), p, 4)); }
+  // Component k of triple j is element 3 * j + k of a, b and c, the 48 floats at p: each component takes the elements
+  // it needs from a and b with one two-source permute and from c with a second one, and storing reverses this.
+  static __m512i indices(const int32_t* table) { return _mm512_loadu_si512(table); }
+  static void loadInterleaved3(const float* p, Float16& x, Float16& y, Float16& z) {
+    static const int32_t first[3][16] = {
+      { 0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 0, 0, 0, 0, 0 },
+      { 1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 0, 0, 0, 0, 0 },
+      { 2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 0, 0, 0, 0, 0 }
+    };
+    static const int32_t second[3][16] = {
+      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29 },
+      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30 },
+      { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31 }
+    };
+    auto a = _mm512_loadu_ps(p), b = _mm512_loadu_ps(p + 16), c = _mm512_loadu_ps(p + 32);
+    Float16* components[] = { &x, &y, &z };
+    for (size_t k = 0; k < 3; k++) {
+      auto ab = _mm512_permutex2var_ps(a, indices(first[k]), b);
+      components[k]->v = _mm512_permutex2var_ps(ab, indices(second[k]), c);
+    }
+  }
+  static void storeInterleaved3(float* p, const Float16 x, const Float16 y, const Float16 z) {
+    static const int32_t first[3][16] = {
+      { 0, 16, 0, 1, 17, 0, 2, 18, 0, 3, 19, 0, 4, 20, 0, 5 },
+      { 21, 0, 6, 22, 0, 7, 23, 0, 8, 24, 0, 9, 25, 0, 10, 26 },
+      { 0, 11, 27, 0, 12, 28, 0, 13, 29, 0, 14, 30, 0, 15, 31, 0 }
+    };
+    static const int32_t second[3][16] = {
+      { 0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15 },
+      { 0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15 },
+      { 26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31 }
+    };
+    for (size_t o = 0; o < 3; o++) {
+      auto xy = _mm512_permutex2var_ps(x.v, indices(first[o]), y.v);
+      _mm512_storeu_ps(p + 16 * o, _mm512_permutex2var_ps(xy, indices(second[o]), z.v));
+    }
+  }
+  void store(float* p) const { _mm512_storeu_ps(p, v); }
+  void storeStrided(float* p, size_t stride) const { _mm512_i32scatter_ps(p, strides(stride), v, 4); }
+  static Float16 loadHalf(const uint16_t* p) {
+    return Float16(_mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+  }
+  void storeHalf(uint16_t* p) const {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+  }
+};
+
+Float16 operator+(const Float16 a, const Float16 b) { return Float16(_mm512_add_ps(a.v, b.v)); }
+Float16 operator-(const Float16 a, const Float16 b) { return Float16(_mm512_sub_ps(a.v, b.v)); }
+Float16 operator*(const Float16 a, const Float16 b) { return Float16(_mm512_mul_ps(a.v, b.v)); }
+Float16 operator/(const Float16 a, const Float16 b) { return Float16(_mm512_div_ps(a.v, b.v)); }
+Float16 operator-(const Float16 a) {
+  return Float16(_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_castps_si512(_mm512_set1_ps(-0.0f)))));
+}
+Mask16 operator<(const Float16 a, const Float16 b) { return Mask16(_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)); }
+Mask16 operator>(const Float16 a, const Float16 b) { return Mask16(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)); }
+Mask16 operator&(const Mask16 a, const Mask16 b) { return Mask16(a.v & b.v); }
+Mask16 operator|(const Mask16 a, const Mask16 b) { return Mask16(a.v | b.v); }
+Float16 abs(const Float16 a) { return Float16(_mm512_abs_ps(a.v)); }
+Float16 min(const Float16 a, const Float16 b) { return Float16(_mm512_min_ps(a.v, b.v)); }
+Float16 max(const Float16 a, const Float16 b) { return Float16(_mm512_max_ps(a.v, b.v)); }
+Float16 sqrt(const Float16 a) { return Float16(_mm512_sqrt_ps(a.v)); }
+Float16 rsqrtEstimate(const Float16 a) { return Float16(_mm512_rsqrt14_ps(a.v)); }
+Float16 floor(const Float16 a) { return Float16(_mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)); }
+Float16 copySign(const Float16 magnitude, const Float16 sign) {
+  auto signBit = _mm512_castps_si512(_mm512_set1_ps(-0.0f));
+  return Float16(_mm512_castsi512_ps(_mm512_or_si512(
+    _mm512_andnot_si512(signBit, _mm512_castps_si512(magnitude.v)),
+    _mm512_and_si512(signBit, _mm512_castps_si512(sign.v)))));
+}
+Float16 select(const Mask16 m, const Float16 a, const Float16 b) { return Float16(_mm512_mask_blend_ps(m.v, b.v, a.v)); }
+Float16 fma(const Float16 a, const Float16 b, const Float16 c) { return Float16(_mm512_fmadd_ps(a.v, b.v, c.v)); }
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+namespace scalar {
+using Float = Float1;
+}
+
+#if SIMD_X86
+namespace sse41 {
+using Float = Float4;
+}
+
+namespace avx2 {
+using Float = Float8;
+}
+
+namespace avx512 {
+using Float = Float16;
+}
+#endif
+
+} // namespace simd
+
+// Returns function<Float>(...) from the namespace compiled for the given tier, which must not exceed supportedTier().
+#if SIMD_X86
+#define SIMD_DISPATCH_TIER(tier, function, ...) \
+  switch (tier) { \
+  case simd::Tier::Avx512: \
+    return simd::avx512::function<simd::avx512::Float>(__VA_ARGS__); \
+  case simd::Tier::Avx2: \
+    return simd::avx2::function<simd::avx2::Float>(__VA_ARGS__); \
+  case simd::Tier::Sse41: \
+    return simd::sse41::function<simd::sse41::Float>(__VA_ARGS__); \
+  default: \
+    return simd::scalar::function<simd::scalar::Float>(__VA_ARGS__); \
+  }
+#else
+#define SIMD_DISPATCH_TIER(tier, function, ...) \
+  return simd::scalar::function<simd::scalar::Float>(__VA_ARGS__)
+#endif
+
+// Same for the active tier.
+#define SIMD_DISPATCH(function, ...) SIMD_DISPATCH_TIER(simd::tier(), function, __VA_ARGS__)
+
+#define SIMD_KERNELS "./simdMath.h"
+#include "./simdTargets.h"
+#undef SIMD_KERNELS
+
+#endif // __SIMD_H__
@@ -0,0 +1,70 @@
+// Lane-generic math shared by every SIMD target. Included once per target namespace through simdTargets.h,
+// so it has no include guard.
+
+template <class V>
+V atan2(const V y, const V x) {
+  auto ax = abs(x);
+  auto ay = abs(y);
+  auto a = min(ax, ay) / max(max(ax, ay), V(FLT_MIN));
+  auto reduced = a > V(0.41421356f);
+  a = select(reduced, (a - V(1)) / (a + V(1)), a);
+  auto z = a * a;
+  auto r = (((V(8.05374449538e-2f) * z - V(1.38776856032e-1f)) * z + V(1.99777106478e-1f)) * z
+    - V(3.33329491539e-1f)) * z * a + a;
+  r = r + select(reduced, V(QUARTER_PI), V(0));
+  r = select(ay > ax, V(HALF_PI) - r, r);
+  r = select(x < V(0), V(PI) - r, r);
+  return copySign(r, y);
+}
+
+template <class V>
+V asin(const V s) {
+  auto as = abs(s);
+  auto reduced = as > V(0.5f);
+  auto zr = max(V(0.5f) * (V(1) - as), V(0));
+  auto z = select(reduced, zr, as * as);
+  auto t = select(reduced, sqrt(zr), as);
+  auto p = ((((V(4.2163199048e-2f) * z + V(2.4181311049e-2f)) * z + V(4.5470025998e-2f)) * z
+    + V(7.4953002686e-2f)) * z + V(1.6666752422e-1f)) * z * t + t;
+  return copySign(select(reduced, V(HALF_PI) - V(2) * p, p), s);
+}
+
+template <class V>
+V reduceQuadrant(const V a, V& quadrant) {
+  quadrant = floor(a * V(2 / PI) + V(0.5f));
+  auto r = ((a - quadrant * V(1.5703125f)) - quadrant * V(4.837512969970703125e-4f)) - quadrant * V(7.54978995489188216e-8f);
+  quadrant = quadrant - V(4) * floor(quadrant * V(0.25f));
+  return r;
+}
+
+template <class V>
+void applyQuadrant(const V quadrant, const V ps, const V pc, V& s, V& c) {
+  auto swapped = ((quadrant > V(0.5f)) & (quadrant < V(1.5f))) | (quadrant > V(2.5f));
+  s = select(swapped, pc, ps);
+  c = select(swapped, ps, pc);
+  s = select(quadrant > V(1.5f), -s, s);
+  c = select((quadrant > V(0.5f)) & (quadrant < V(2.5f)), -c, c);
+}
+
+// Shares one Cody-Waite reduction to [-PI/4, PI/4] between sine and cosine, max error about 1 ulp for |a| < 8192.
+template <class V>
+void sincos(const V a, V& s, V& c) {
+  V quadrant;
+  auto r = reduceQuadrant(a, quadrant);
+  auto z = r * r;
+  auto ps = ((V(-1.9515295891e-4f) * z + V(8.3321608736e-3f)) * z - V(1.6666654611e-1f)) * z * r + r;
+  auto pc = ((V(2.443315711809948e-5f) * z - V(1.388731625493765e-3f)) * z + V(4.166664568298827e-2f)) * z * z
+    - V(0.5f) * z + V(1);
+  applyQuadrant(quadrant, ps, pc, s, c);
+}
+
+// Degree 5 sine and degree 4 cosine minimax fits on [-PI/4, PI/4], max error 1.3e-5 for |a| < 8192.
+template <class V>
+void sincosFastest(const V a, V& s, V& c) {
+  V quadrant;
+  auto r = reduceQuadrant(a, quadrant);
+  auto z = r * r;
+  auto ps = (V(8.152982552675736e-3f) * z - V(1.6662833393713603e-1f)) * z * r + r;
+  auto pc = (V(4.0488874668426586e-2f) * z - V(4.997762841491419e-1f)) * z + V(1);
+  applyQuadrant(quadrant, ps, pc, s, c);
+}
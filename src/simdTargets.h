@@ -0,0 +1,37 @@
+// Includes the file named by SIMD_KERNELS once per SIMD target, each copy in its own namespace and compiled for
+// that target, so lane-generic templates never run on a CPU that lacks the instructions. No include guard on purpose.
+
+namespace simd {
+namespace scalar {
+#include SIMD_KERNELS
+}
+}
+
+#if SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+namespace simd {
+namespace sse41 {
+#include SIMD_KERNELS
+}
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+namespace simd {
+namespace avx2 {
+#include SIMD_KERNELS
+}
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma,f16c")
+namespace simd {
+namespace avx512 {
+#include SIMD_KERNELS
+}
+}
+#pragma GCC pop_options
+#endif
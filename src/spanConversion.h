@@ -0,0 +1,125 @@
+#ifndef __SPANCONVERSION_H__
+#define __SPANCONVERSION_H__
+
+#include <cstddef>
+#include <span>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./RotationMatrix.h"
+#include "./conversion.h"
+
+// Conversions from const input spans into caller-owned output spans. Inputs are read in place through references,
+// so rotation matrices are never copied, results are assigned straight into the output elements and a successful
+// call allocates nothing on the heap. The euler order is resolved once per call, not per element. The output must
+// hold at least as many elements as the input; only the first input.size() of them are written. A too small output
+// or an invalid euler order throws, and throwing allocates the exception object.
+
+void checkSpanSizes(size_t inputSize, size_t outputSize) {
+  if (outputSize < inputSize) {
+    throw "output span is too small.";
+  }
+}
+
+template <typename T>
+void toEulerAngleSpan(std::span<const BasicQuaternion<T>> q, EulerOrder order, std::span<BasicEulerAngle<T>> result) {
+  checkSpanSizes(q.size(), result.size());
+  withEulerOrder(order, [&](auto o) {
+    for (size_t i = 0; i < q.size(); i++) {
+      result[i] = QuaternionToEulerAngle<decltype(o)::value>::convert(q[i]);
+    }
+  });
+}
+
+template <typename T>
+void toEulerAngleSpan(std::span<const BasicRotationMatrix<T>> m, EulerOrder order, std::span<BasicEulerAngle<T>> result) {
+  checkSpanSizes(m.size(), result.size());
+  withEulerOrder(order, [&](auto o) {
+    for (size_t i = 0; i < m.size(); i++) {
+      result[i] = RotationMatrixToEulerAngle<decltype(o)::value>::convert(m[i]);
+    }
+  });
+}
+
+template <typename T>
+void toQuaternionSpan(std::span<const BasicEulerAngle<T>> e, std::span<BasicQuaternion<T>> result) {
+  checkSpanSizes(e.size(), result.size());
+  for (size_t i = 0; i < e.size(); i++) {
+    result[i] = toQuaternion(e[i]);
+  }
+}
+
+template <typename T>
+void toQuaternionSpan(std::span<const BasicRotationMatrix<T>> m, std::span<BasicQuaternion<T>> result) {
+  checkSpanSizes(m.size(), result.size());
+  for (size_t i = 0; i < m.size(); i++) {
+    result[i] = RotationMatrixToQuaternion::convert(m[i]);
+  }
+}
+
+template <typename T>
+void toRotationMatrixSpan(std::span<const BasicEulerAngle<T>> e, std::span<BasicRotationMatrix<T>> result) {
+  checkSpanSizes(e.size(), result.size());
+  for (size_t i = 0; i < e.size(); i++) {
+    result[i] = toRotationMatrix(e[i]);
+  }
+}
+
+template <typename T>
+void toRotationMatrixSpan(std::span<const BasicQuaternion<T>> q, std::span<BasicRotationMatrix<T>> result) {
+  checkSpanSizes(q.size(), result.size());
+  for (size_t i = 0; i < q.size(); i++) {
+    result[i] = QuaternionToRotationMatrix::convert(q[i]);
+  }
+}
+
+// Non-template overloads so that containers and arrays convert to spans implicitly at the call site.
+void toEulerAngle(std::span<const Quaternion> q, EulerOrder order, std::span<EulerAngle> result) {
+  toEulerAngleSpan(q, order, result);
+}
+
+void toEulerAngle(std::span<const Quaterniond> q, EulerOrder order, std::span<EulerAngled> result) {
+  toEulerAngleSpan(q, order, result);
+}
+
+void toEulerAngle(std::span<const RotationMatrix> m, EulerOrder order, std::span<EulerAngle> result) {
+  toEulerAngleSpan(m, order, result);
+}
+
+void toEulerAngle(std::span<const RotationMatrixd> m, EulerOrder order, std::span<EulerAngled> result) {
+  toEulerAngleSpan(m, order, result);
+}
+
+void toQuaternion(std::span<const EulerAngle> e, std::span<Quaternion> result) {
+  toQuaternionSpan(e, result);
+}
+
+void toQuaternion(std::span<const EulerAngled> e, std::span<Quaterniond> result) {
+  toQuaternionSpan(e, result);
+}
+
+void toQuaternion(std::span<const RotationMatrix> m, std::span<Quaternion> result) {
+  toQuaternionSpan(m, result);
+}
+
+void toQuaternion(std::span<const RotationMatrixd> m, std::span<Quaterniond> result) {
+  toQuaternionSpan(m, result);
+}
+
+void toRotationMatrix(std::span<const EulerAngle> e, std::span<RotationMatrix> result) {
+  toRotationMatrixSpan(e, result);
+}
+
+void toRotationMatrix(std::span<const EulerAngled> e, std::span<RotationMatrixd> result) {
+  toRotationMatrixSpan(e, result);
+}
+
+void toRotationMatrix(std::span<const Quaternion> q, std::span<RotationMatrix> result) {
+  toRotationMatrixSpan(q, result);
+}
+
+void toRotationMatrix(std::span<const Quaterniond> q, std::span<RotationMatrixd> result) {
+  toRotationMatrixSpan(q, result);
+}
+
+#endif // __SPANCONVERSION_H__
@@ -0,0 +1,98 @@
+#ifndef __TRACKRESAMPLING_H__
+#define __TRACKRESAMPLING_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "./EulerAngle.h"
+#include "./Quaternion.h"
+#include "./ThreadPool.h"
+#include "./batchInterpolation.h"
+#include "./conversion.h"
+
+// Sparse keyframed euler track viewing caller-owned arrays of count key times, strictly increasing, and keys. The
+// order of each key is taken from the key itself, so tracks can use different orders.
+class EulerAngleTrack {
+public:
+  const float* times;
+  const EulerAngle* keys;
+  size_t count;
+};
+
+// Frames of a track resampled at rate frames per second, from its first key time up to its last one.
+size_t resampledFrameCount(const EulerAngleTrack& track, float rate) {
+  if (track.count == 0) {
+    throw "track has no keys.";
+  }
+  if (!(rate > 0)) {
+    throw "resampling rate is invalid.";
+  }
+  auto duration = track.times[track.count - 1] - track.times[0];
+  return static_cast<size_t>(std::floor(duration * rate + 1e-3f)) + 1;
+}
+
+// Index of the first frame of each track in the contiguous output of resampleTracks, plus the total frame count
+// as the last element.
+std::vector<size_t> resampledTrackOffsets(const EulerAngleTrack* tracks, size_t count, float rate) {
+  std::vector<size_t> offsets(count + 1, 0);
+  for (size_t i = 0; i < count; i++) {
+    offsets[i + 1] = offsets[i] + resampledFrameCount(tracks[i], rate);
+  }
+  return offsets;
+}
+
+// Resamples one track in a single pass: keys are converted with toQuaternion(EulerAngle) only when the frame time
+// reaches them, each negated if needed to stay in the hemisphere of the previous key, and the bracketing keys of
+// SAMPLE_CHUNK frames at a time are gathered for one interpolateBatch call.
+void resampleTrack(const EulerAngleTrack& track, float rate, Interpolation mode, Quaternion* result) {
+  auto frames = resampledFrameCount(track, rate);
+  float ax[SAMPLE_CHUNK], ay[SAMPLE_CHUNK], az[SAMPLE_CHUNK], aw[SAMPLE_CHUNK];
+  float bx[SAMPLE_CHUNK], by[SAMPLE_CHUNK], bz[SAMPLE_CHUNK], bw[SAMPLE_CHUNK];
+  float t[SAMPLE_CHUNK];
+  auto a = toQuaternion(track.keys[0]);
+  auto b = a;
+  size_t next = 0;
+  for (size_t begin = 0; begin < frames; begin += SAMPLE_CHUNK) {
+    auto n = std::min(SAMPLE_CHUNK, frames - begin);
+    for (size_t j = 0; j < n; j++) {
+      auto time = track.times[0] + (begin + j) / rate;
+      while (next + 1 < track.count && (next == 0 || track.times[next] <= time)) {
+        a = b;
+        next++;
+        b = toQuaternion(track.keys[next]);
+        if (dot(a, b) < 0) {
+          b = Quaternion(-b.x, -b.y, -b.z, -b.w);
+        }
+      }
+      // Past the last key, or a single key, holds b.
+      t[j] = next == 0 || time >= track.times[next] ? 1 :
+        (time - track.times[next - 1]) / (track.times[next] - track.times[next - 1]);
+      ax[j] = a.x;
+      ay[j] = a.y;
+      az[j] = a.z;
+      aw[j] = a.w;
+      bx[j] = b.x;
+      by[j] = b.y;
+      bz[j] = b.z;
+      bw[j] = b.w;
+    }
+    interpolateBatch(mode, ax, ay, az, aw, bx, by, bz, bw, t, n, ax, ay, az, aw);
+    for (size_t j = 0; j < n; j++) {
+      result[begin + j] = Quaternion(ax[j], ay[j], az[j], aw[j]);
+    }
+  }
+}
+
+// Resamples every track into result, laid out by resampledTrackOffsets, with one task per track on the pool.
+void resampleTracks(ThreadPool& pool, const EulerAngleTrack* tracks, size_t count, float rate, Interpolation mode,
+    const size_t* offsets, Quaternion* result) {
+  pool.parallelFor(count, 1, [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; i++) {
+      resampleTrack(tracks[i], rate, mode, result + offsets[i]);
+    }
+  });
+}
+
+#endif // __TRACKRESAMPLING_H__
@@ -1,5 +1,11 @@
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -8,6 +14,22 @@
 #include "../src/RotationMatrix.h"
 #include "../src/Vector3.h"
 #include "../src/conversion.h"
+#include "../src/batchConversion.h"
+#include "../src/batchRotation.h"
+#include "../src/parallelConversion.h"
+#include "../src/executionConversion.h"
+#include "../src/rotationFileConversion.h"
+#include "../src/QuaternionCodec.h"
+#include "../src/spanConversion.h"
+#include "../src/SinCosTable.h"
+#include "../src/EulerAngleCache.h"
+#include "../src/EulerAngleStream.h"
+#include "../src/batchInterpolation.h"
+#include "../src/trackResampling.h"
+#include "../src/hierarchy.h"
+#include "../src/orthonormalization.h"
+#include "../src/quaternionNormalization.h"
+#include "../cli/convert.h"
 
 const float PI = 3.14159265359f;
 const float HALF_PI = 0.5f * PI;
@@ -1871,4 +1893,1233 @@ TEST(RotationMatrixToQuaternion, RotationZ) {
   EXPECT_TRUE(equals(mx90 * v001, qx90.rotate(v001)));
   EXPECT_TRUE(equals(mx180 * v001, qx180.rotate(v001)));
   EXPECT_TRUE(equals(mx270 * v001, qx270.rotate(v001)));
-}
\ No newline at end of file
+}
+
+bool equals(RotationMatrix m1, RotationMatrix m2, float error = 0.0001f) {
+  for (size_t i = 0; i < 9; i++) {
+    if (std::abs(m1[i] - m2[i]) >= error) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const EulerOrder EULER_ORDERS[] = {
+  EulerOrder::XYZ, EulerOrder::XZY, EulerOrder::YXZ, EulerOrder::YZX, EulerOrder::ZXY, EulerOrder::ZYX
+};
+
+TEST(QuaternionToEulerAngleBatch, MatchesScalar) {
+  std::vector<float> xs, ys, zs, ws;
+  for (auto i = 0; i < 203; i++) {
+    auto q = calculateQuaternion(EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::ZYX));
+    xs.push_back(q.x);
+    ys.push_back(q.y);
+    zs.push_back(q.z);
+    ws.push_back(q.w);
+  }
+  for (auto order : EULER_ORDERS) {
+    auto q = calculateQuaternion(EulerAngle(0.3f, HALF_PI, -0.8f, order));
+    xs.push_back(q.x);
+    ys.push_back(q.y);
+    zs.push_back(q.z);
+    ws.push_back(q.w);
+  }
+  auto count = xs.size();
+  std::vector<float> ex(count), ey(count), ez(count);
+  // Field of the middle angle of each order, whose sine reaches 1 in gimbal lock.
+  const size_t middle[] = { 1, 2, 0, 2, 0, 1 };
+  auto angleError = [](float a, float b) { return std::abs(std::remainder(a - b, 2 * PI)); };
+  auto supported = simd::supportedTier();
+  size_t checked = 0;
+  for (auto tier : { simd::Tier::Scalar, simd::Tier::Sse41, simd::Tier::Avx2, simd::Tier::Avx512 }) {
+    simd::setTier(tier);
+    for (auto order : EULER_ORDERS) {
+      toEulerAngleBatch(xs.data(), ys.data(), zs.data(), ws.data(), count, order, ex.data(), ey.data(), ez.data());
+      for (size_t i = 0; i < count; i++) {
+        SCOPED_TRACE(testing::Message() << "tier " << static_cast<int>(tier) << ", order " << static_cast<int>(order)
+          << ", index " << i);
+        auto expected = toEulerAngle(Quaternion(xs[i], ys[i], zs[i], ws[i]), order);
+        auto actual = EulerAngle(ex[i], ey[i], ez[i], order);
+        EXPECT_TRUE(equals(toRotationMatrix(expected), toRotationMatrix(actual)));
+        // Away from gimbal lock, every angle is within the 5e-5 rad documented for toEulerAngleBatch.
+        float fields[] = { expected.x, expected.y, expected.z };
+        if (std::abs(std::sin(fields[middle[static_cast<size_t>(order)]])) < 0.999f) {
+          checked++;
+          EXPECT_LT(angleError(expected.x, actual.x), 5e-5f);
+          EXPECT_LT(angleError(expected.y, actual.y), 5e-5f);
+          EXPECT_LT(angleError(expected.z, actual.z), 5e-5f);
+        }
+      }
+    }
+  }
+  simd::setTier(supported);
+  EXPECT_GT(checked, 4 * 6 * 180u);
+}
+
+TEST(RotationMatrixToQuaternionBatch, MatchesScalar) {
+  std::vector<float> elements;
+  for (auto i = 0; i < 203; i++) {
+    auto m = calculateRotationMatrix(EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EULER_ORDERS[i % 6]));
+    elements.insert(elements.end(), m.elements.begin(), m.elements.end());
+  }
+  for (auto angle : { 0.0f, HALF_PI, PI }) {
+    for (auto m : { RotationMatrix::rotationX(angle), RotationMatrix::rotationY(angle), RotationMatrix::rotationZ(angle) }) {
+      elements.insert(elements.end(), m.elements.begin(), m.elements.end());
+    }
+  }
+  auto count = elements.size() / 9;
+  std::vector<float> x(count), y(count), z(count), w(count);
+  toQuaternionBatch(elements.data(), count, x.data(), y.data(), z.data(), w.data());
+  for (size_t i = 0; i < count; i++) {
+    RotationMatrix m({
+      elements[9 * i], elements[9 * i + 1], elements[9 * i + 2],
+      elements[9 * i + 3], elements[9 * i + 4], elements[9 * i + 5],
+      elements[9 * i + 6], elements[9 * i + 7], elements[9 * i + 8]
+    });
+    auto expected = toQuaternion(m);
+    EXPECT_NEAR(expected.x, x[i], 1e-5f) << "index " << i;
+    EXPECT_NEAR(expected.y, y[i], 1e-5f) << "index " << i;
+    EXPECT_NEAR(expected.z, z[i], 1e-5f) << "index " << i;
+    EXPECT_NEAR(expected.w, w[i], 1e-5f) << "index " << i;
+  }
+}
+
+TEST(EulerAngleToRotationMatrixBatch, MatchesScalar) {
+  std::vector<float> xs, ys, zs;
+  for (auto i = 0; i < 203; i++) {
+    xs.push_back(0.37f * i - 20);
+    ys.push_back(0.11f * i - 3);
+    zs.push_back(1.7f - 0.23f * i);
+  }
+  for (auto angle : { 0.0f, HALF_PI, PI, -HALF_PI, -PI, TWO_PI }) {
+    xs.push_back(angle);
+    ys.push_back(-angle);
+    zs.push_back(angle);
+  }
+  auto count = xs.size();
+  std::vector<float> elements(9 * count);
+  for (auto order : EULER_ORDERS) {
+    toRotationMatrixBatch(xs.data(), ys.data(), zs.data(), count, order, elements.data());
+    for (size_t i = 0; i < count; i++) {
+      auto expected = toRotationMatrix(EulerAngle(xs[i], ys[i], zs[i], order));
+      for (size_t j = 0; j < 9; j++) {
+        EXPECT_NEAR(expected[j], elements[9 * i + j], 1e-5f) << "order " << static_cast<int>(order) << ", index " << i;
+      }
+    }
+  }
+}
+
+template <TrigPrecision P>
+float maxQuaternionError() {
+  auto error = 0.0f;
+  for (auto order : EULER_ORDERS) {
+    for (auto i = -2000; i <= 2000; i++) {
+      auto e = EulerAngle(0.00157f * i, -0.0041f * i + 1, 0.0029f * i - 2, order);
+      auto expected = toQuaternion(e);
+      auto actual = toQuaternion<P>(e);
+      error = std::max(error, std::abs(expected.x - actual.x));
+      error = std::max(error, std::abs(expected.y - actual.y));
+      error = std::max(error, std::abs(expected.z - actual.z));
+      error = std::max(error, std::abs(expected.w - actual.w));
+    }
+  }
+  return error;
+}
+
+TEST(EulerAngleToQuaternion, Precision) {
+  EXPECT_EQ(0.0f, maxQuaternionError<TrigPrecision::Exact>());
+  EXPECT_LT(maxQuaternionError<TrigPrecision::Fast>(), 1e-6f);
+  EXPECT_LT(maxQuaternionError<TrigPrecision::Fastest>(), 1e-4f);
+}
+
+template <EulerOrder O>
+void expectCompileTimeOrderMatches() {
+  for (auto i = 0; i < 50; i++) {
+    auto e = EulerAngle(0.37f * i - 9, 0.11f * i - 3, 1.7f - 0.23f * i, O);
+    // Baseline formulas: products of the single-axis rotations.
+    auto expectedMatrix = calculateRotationMatrix(e);
+    auto expectedQuaternion = calculateQuaternion(e);
+    auto m = toRotationMatrix<O>(e);
+    for (size_t j = 0; j < 9; j++) {
+      EXPECT_NEAR(expectedMatrix.elements[j], m.elements[j], 1e-5f) << "index " << i << " element " << j;
+    }
+    auto q = toQuaternion<O>(e);
+    EXPECT_NEAR(expectedQuaternion.x, q.x, 1e-5f) << "index " << i;
+    EXPECT_NEAR(expectedQuaternion.y, q.y, 1e-5f) << "index " << i;
+    EXPECT_NEAR(expectedQuaternion.z, q.z, 1e-5f) << "index " << i;
+    EXPECT_NEAR(expectedQuaternion.w, q.w, 1e-5f) << "index " << i;
+    // Euler angles are not unique, so they are checked through the rotation they describe. In gimbal lock the middle
+    // angle is taken as it is, so the error grows up to the square root of the lock threshold's distance from 1.
+    auto error = isGimbalLocked<O>(expectedMatrix) ? 5e-3f : 1e-4f;
+    auto eq = toEulerAngle<O>(expectedQuaternion);
+    auto em = toEulerAngle<O>(expectedMatrix);
+    EXPECT_EQ(O, eq.order);
+    EXPECT_EQ(O, em.order);
+    auto mq = calculateRotationMatrix(eq), mm = calculateRotationMatrix(em);
+    for (size_t j = 0; j < 9; j++) {
+      EXPECT_NEAR(expectedMatrix.elements[j], mq.elements[j], error) << "index " << i << " element " << j;
+      EXPECT_NEAR(expectedMatrix.elements[j], mm.elements[j], error) << "index " << i << " element " << j;
+    }
+  }
+}
+
+TEST(CompileTimeOrder, MatchesBaselineFormulas) {
+  expectCompileTimeOrderMatches<EulerOrder::XYZ>();
+  expectCompileTimeOrderMatches<EulerOrder::XZY>();
+  expectCompileTimeOrderMatches<EulerOrder::YXZ>();
+  expectCompileTimeOrderMatches<EulerOrder::YZX>();
+  expectCompileTimeOrderMatches<EulerOrder::ZXY>();
+  expectCompileTimeOrderMatches<EulerOrder::ZYX>();
+}
+
+TEST(QuaternionRotate, MatchesHamiltonProduct) {
+  for (auto i = 0; i < 50; i++) {
+    auto q = calculateQuaternion(EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::XYZ));
+    auto v = Vector3(0.5f * i - 7, 3 - 0.2f * i, 0.1f * i);
+    auto p = q * Quaternion(v.x, v.y, v.z, 0) * conjugate(q);
+    EXPECT_TRUE(equals(Vector3(p.x, p.y, p.z), q.rotate(v), 1e-4f));
+  }
+}
+
+TEST(QuaternionRotateBatch, MatchesScalar) {
+  std::vector<float> qx, qy, qz, qw, vx, vy, vz;
+  for (auto i = 0; i < 203; i++) {
+    auto q = calculateQuaternion(EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::ZXY));
+    qx.push_back(q.x);
+    qy.push_back(q.y);
+    qz.push_back(q.z);
+    qw.push_back(q.w);
+    vx.push_back(0.5f * i - 7);
+    vy.push_back(3 - 0.2f * i);
+    vz.push_back(0.1f * i);
+  }
+  auto count = qx.size();
+  std::vector<float> rx(count), ry(count), rz(count);
+  rotateBatch(qx.data(), qy.data(), qz.data(), qw.data(), vx.data(), vy.data(), vz.data(), count, rx.data(), ry.data(), rz.data());
+  for (size_t i = 0; i < count; i++) {
+    auto expected = Quaternion(qx[i], qy[i], qz[i], qw[i]).rotate(Vector3(vx[i], vy[i], vz[i]));
+    EXPECT_TRUE(equals(expected, Vector3(rx[i], ry[i], rz[i]), 1e-4f)) << "index " << i;
+  }
+}
+
+TEST(RotationMatrixRotateBatch, MatchesScalar) {
+  auto m = calculateRotationMatrix(EulerAngle(0.3f, -1.2f, 2.5f, EulerOrder::YZX));
+  auto q = toQuaternion(m);
+  std::vector<float> x, y, z, xyz;
+  for (auto i = 0; i < 203; i++) {
+    x.push_back(0.5f * i - 7);
+    y.push_back(3 - 0.2f * i);
+    z.push_back(0.1f * i);
+    xyz.insert(xyz.end(), { x.back(), y.back(), z.back() });
+  }
+  auto count = x.size();
+  std::vector<float> rx(count), ry(count), rz(count), qx(x), qy(y), qz(z), rxyz(3 * count), qxyz(xyz);
+  rotateBatch(m, x.data(), y.data(), z.data(), count, rx.data(), ry.data(), rz.data());
+  rotateBatch(q, qx.data(), qy.data(), qz.data(), count, qx.data(), qy.data(), qz.data());
+  rotateInterleavedBatch(m, xyz.data(), count, rxyz.data());
+  rotateInterleavedBatch(q, qxyz.data(), count, qxyz.data());
+  for (size_t i = 0; i < count; i++) {
+    auto expected = m * Vector3(x[i], y[i], z[i]);
+    EXPECT_TRUE(equals(expected, Vector3(rx[i], ry[i], rz[i]), 1e-4f)) << "index " << i;
+    EXPECT_TRUE(equals(expected, Vector3(qx[i], qy[i], qz[i]), 1e-4f)) << "index " << i;
+    EXPECT_TRUE(equals(expected, Vector3(rxyz[3 * i], rxyz[3 * i + 1], rxyz[3 * i + 2]), 1e-4f)) << "index " << i;
+    EXPECT_TRUE(equals(expected, Vector3(qxyz[3 * i], qxyz[3 * i + 1], qxyz[3 * i + 2]), 1e-4f)) << "index " << i;
+  }
+}
+
+TEST(SimdTier, ParsesForcedTier) {
+  auto supported = simd::supportedTier();
+  EXPECT_EQ(simd::Tier::Scalar, simd::parseTier("scalar"));
+  EXPECT_EQ(std::min(simd::Tier::Sse41, supported), simd::parseTier("sse4.1"));
+  EXPECT_EQ(std::min(simd::Tier::Avx2, supported), simd::parseTier("avx2"));
+  EXPECT_EQ(supported, simd::parseTier("avx512"));
+  EXPECT_THROW(simd::parseTier("avx-512"), const char*);
+  EXPECT_THROW(simd::parseTier(""), const char*);
+}
+
+TEST(SimdTier, TiersMatchScalar) {
+  std::vector<float> x, y, z, w, angles, elements;
+  for (auto i = 0; i < 203; i++) {
+    auto e = EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::XZY);
+    auto q = toQuaternion(e);
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+    angles.insert(angles.end(), { e.x, e.y, e.z });
+    auto m = toRotationMatrix(e);
+    elements.insert(elements.end(), m.elements.begin(), m.elements.end());
+  }
+  auto count = x.size();
+  auto run = [&](simd::Tier tier) {
+    simd::setTier(tier);
+    std::vector<float> result(10 * count);
+    toEulerAngleBatch(x.data(), y.data(), z.data(), w.data(), count, EulerOrder::XZY,
+      result.data(), result.data() + count, result.data() + 2 * count);
+    toQuaternionBatch(elements.data(), count, result.data() + 3 * count, result.data() + 4 * count,
+      result.data() + 5 * count, result.data() + 6 * count);
+    rotateBatch(x.data(), y.data(), z.data(), w.data(), x.data(), y.data(), z.data(), count,
+      result.data() + 7 * count, result.data() + 8 * count, result.data() + 9 * count);
+    std::vector<float> matrices(9 * count);
+    toRotationMatrixBatch(x.data(), y.data(), z.data(), count, EulerOrder::XZY, matrices.data());
+    result.insert(result.end(), matrices.begin(), matrices.end());
+    std::vector<float> points(angles);
+    rotateInterleavedBatch(toRotationMatrix(EulerAngle(1, 2, 3, EulerOrder::XYZ)), points.data(), count, points.data());
+    result.insert(result.end(), points.begin(), points.end());
+    return result;
+  };
+  auto expected = run(simd::Tier::Scalar);
+  auto supported = simd::supportedTier();
+  for (auto tier : { simd::Tier::Sse41, simd::Tier::Avx2, simd::Tier::Avx512 }) {
+    auto actual = run(tier);
+    EXPECT_EQ(tier <= supported ? tier : supported, simd::tier());
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_NEAR(expected[i], actual[i], 1e-4f) << "tier " << static_cast<int>(tier) << ", index " << i;
+    }
+  }
+  simd::setTier(supported);
+}
+
+TEST(DoublePrecision, MatchesFloat) {
+  for (auto order : EULER_ORDERS) {
+    auto e = EulerAngle(0.3f, -1.2f, 0.5f, order);
+    auto ed = EulerAngled(0.3, -1.2, 0.5, order);
+    auto q = toQuaternion(e);
+    auto qd = toQuaternion(ed);
+    EXPECT_NEAR(q.x, qd.x, 1e-6);
+    EXPECT_NEAR(q.y, qd.y, 1e-6);
+    EXPECT_NEAR(q.z, qd.z, 1e-6);
+    EXPECT_NEAR(q.w, qd.w, 1e-6);
+    auto back = toEulerAngle(toRotationMatrix(qd), order);
+    EXPECT_NEAR(ed.x, back.x, 1e-12);
+    EXPECT_NEAR(ed.y, back.y, 1e-12);
+    EXPECT_NEAR(ed.z, back.z, 1e-12);
+  }
+}
+
+TEST(Half, RoundTrip) {
+  for (auto value : { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f }) {
+    EXPECT_EQ(value, static_cast<float>(Half(value)));
+  }
+  EXPECT_EQ(1.0f, static_cast<float>(Half(1.0f + 1.0f / 4096)));
+  EXPECT_EQ(0x7c00, Half(1e6f).bits);
+  EXPECT_TRUE(std::isnan(static_cast<float>(Half(NAN))));
+  EXPECT_EQ(1.0f, static_cast<float>(BFloat16(1.001f)));
+  EXPECT_EQ(-3.0f, static_cast<float>(BFloat16(-3.0f)));
+  EXPECT_TRUE(std::isnan(static_cast<float>(BFloat16(NAN))));
+
+  std::vector<Half> halves(301);
+  for (size_t i = 0; i < halves.size(); i++) {
+    halves[i].bits = static_cast<uint16_t>(i * 211);
+  }
+  std::vector<float> widened(halves.size());
+  std::vector<Half> narrowed(halves.size());
+  for (auto tier : { simd::Tier::Scalar, simd::Tier::Sse41, simd::Tier::Avx2, simd::Tier::Avx512 }) {
+    simd::setTier(tier);
+    widenBatch(halves.data(), halves.size(), widened.data());
+    narrowBatch(widened.data(), widened.size(), narrowed.data());
+    for (size_t i = 0; i < halves.size(); i++) {
+      auto expected = static_cast<float>(halves[i]);
+      if (std::isnan(expected)) {
+        EXPECT_TRUE(std::isnan(widened[i]));
+      } else {
+        EXPECT_EQ(expected, widened[i]) << "tier " << static_cast<int>(tier) << ", index " << i;
+        EXPECT_EQ(halves[i].bits, narrowed[i].bits) << "tier " << static_cast<int>(tier) << ", index " << i;
+      }
+    }
+  }
+  simd::setTier(simd::supportedTier());
+}
+
+template <typename H>
+std::vector<float> widen(const std::vector<H>& values) {
+  std::vector<float> result;
+  for (auto value : values) {
+    result.push_back(static_cast<float>(value));
+  }
+  return result;
+}
+
+// Every result is compared with the float path run on the widened inputs, so only the final narrowing is measured.
+template <typename H>
+void expectHalfBatchMatchesFloat(float error) {
+  std::vector<H> x, y, z, w, elements;
+  for (auto i = 0; i < 300; i++) {
+    auto e = EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::YXZ);
+    auto q = toQuaternion(e);
+    auto m = toRotationMatrix(e);
+    x.push_back(H(q.x));
+    y.push_back(H(q.y));
+    z.push_back(H(q.z));
+    w.push_back(H(q.w));
+    for (auto element : m.elements) {
+      elements.push_back(H(element));
+    }
+  }
+  auto count = x.size();
+  std::vector<H> ex(count), ey(count), ez(count), qx(count), qy(count), qz(count), qw(count), matrices(9 * count);
+  toEulerAngleBatch(x.data(), y.data(), z.data(), w.data(), count, EulerOrder::YXZ, ex.data(), ey.data(), ez.data());
+  toQuaternionBatch(elements.data(), count, qx.data(), qy.data(), qz.data(), qw.data());
+  toRotationMatrixBatch(ex.data(), ey.data(), ez.data(), count, EulerOrder::YXZ, matrices.data());
+
+  auto fx = widen(x), fy = widen(y), fz = widen(z), fw = widen(w), fe = widen(elements);
+  std::vector<float> rx(count), ry(count), rz(count), rw(count), rm(9 * count);
+  toEulerAngleBatch(fx.data(), fy.data(), fz.data(), fw.data(), count, EulerOrder::YXZ, rx.data(), ry.data(), rz.data());
+  toQuaternionBatch(fe.data(), count, rx.data(), ry.data(), rz.data(), rw.data());
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_NEAR(rx[i], static_cast<float>(qx[i]), error) << "index " << i;
+    EXPECT_NEAR(ry[i], static_cast<float>(qy[i]), error) << "index " << i;
+    EXPECT_NEAR(rz[i], static_cast<float>(qz[i]), error) << "index " << i;
+    EXPECT_NEAR(rw[i], static_cast<float>(qw[i]), error) << "index " << i;
+  }
+  toEulerAngleBatch(fx.data(), fy.data(), fz.data(), fw.data(), count, EulerOrder::YXZ, rx.data(), ry.data(), rz.data());
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_NEAR(rx[i], static_cast<float>(ex[i]), PI * error) << "index " << i;
+    EXPECT_NEAR(ry[i], static_cast<float>(ey[i]), PI * error) << "index " << i;
+    EXPECT_NEAR(rz[i], static_cast<float>(ez[i]), PI * error) << "index " << i;
+  }
+  auto ax = widen(ex), ay = widen(ey), az = widen(ez);
+  toRotationMatrixBatch(ax.data(), ay.data(), az.data(), count, EulerOrder::YXZ, rm.data());
+  for (size_t i = 0; i < 9 * count; i++) {
+    EXPECT_NEAR(rm[i], static_cast<float>(matrices[i]), error) << "index " << i;
+  }
+}
+
+TEST(HalfBatch, MatchesFloat) {
+  expectHalfBatchMatchesFloat<Half>(1.0f / 1024);
+  expectHalfBatchMatchesFloat<BFloat16>(1.0f / 128);
+}
+
+TEST(ParallelConversion, MatchesSequential) {
+  const size_t count = 20011;
+  std::vector<Quaternion> quaternions;
+  std::vector<float> x, y, z, w;
+  for (size_t i = 0; i < count; i++) {
+    auto q = toQuaternion(EulerAngle(0.37f * i, 0.11f * i - 3, 1.7f - 0.23f * i, EulerOrder::YZX));
+    quaternions.push_back(q);
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  std::vector<float> ex(count), ey(count), ez(count);
+  toEulerAngleBatch(x.data(), y.data(), z.data(), w.data(), count, EulerOrder::YZX, ex.data(), ey.data(), ez.data());
+  for (size_t threads : { 1, 2, 3, 8 }) {
+    ThreadPool pool(threads);
+    EXPECT_EQ(threads, pool.threadCount());
+    std::vector<EulerAngle> angles(count, EulerAngle(0, 0, 0, EulerOrder::XYZ));
+    toEulerAngle(pool, quaternions.data(), count, EulerOrder::YZX, angles.data());
+    std::vector<float> px(count), py(count), pz(count);
+    toEulerAngleBatch(pool, x.data(), y.data(), z.data(), w.data(), count, EulerOrder::YZX, px.data(), py.data(), pz.data());
+    // Bitwise identical results are expected, including the NaN that unclamped inputs can produce.
+    auto same = [](float a, float b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+    for (size_t i = 0; i < count; i++) {
+      auto expected = toEulerAngle(quaternions[i], EulerOrder::YZX);
+      ASSERT_TRUE(same(expected.x, angles[i].x) && same(expected.y, angles[i].y) && same(expected.z, angles[i].z))
+        << "threads " << threads << ", index " << i;
+      ASSERT_EQ(EulerOrder::YZX, angles[i].order);
+      ASSERT_TRUE(same(ex[i], px[i]) && same(ey[i], py[i]) && same(ez[i], pz[i])) << "threads " << threads << ", index " << i;
+    }
+  }
+}
+
+TEST(ParallelConversion, PropagatesErrors) {
+  ThreadPool pool(4);
+  std::vector<EulerAngle> angles(10000, EulerAngle(0, 0, 0, EulerOrder::XYZ));
+  angles[7777].order = static_cast<EulerOrder>(42);
+  std::vector<Quaternion> quaternions(angles.size(), Quaternion(0, 0, 0, 1));
+  EXPECT_THROW(toQuaternion(pool, angles.data(), angles.size(), quaternions.data()), const char*);
+  angles[7777].order = EulerOrder::XYZ;
+  toQuaternion(pool, angles.data(), angles.size(), quaternions.data());
+}
+
+TEST(ExecutionPolicy, MatchesScalar) {
+  std::vector<EulerAngle> angles;
+  for (auto i = 0; i < 1000; i++) {
+    angles.push_back(EulerAngle(0.37f * i - 20, 0.011f * i - 3, 1.7f - 0.23f * i, EULER_ORDERS[i / 600]));
+  }
+  std::vector<Quaternion> quaternions(angles.size(), Quaternion(0, 0, 0, 1));
+  std::vector<RotationMatrix> matrices(angles.size(), RotationMatrix::rotationX(0));
+  std::vector<EulerAngle> back(angles.size(), EulerAngle(0, 0, 0, EulerOrder::XYZ));
+  auto run = [&](auto&& policy, float error) {
+    EXPECT_EQ(quaternions.end(), toQuaternion(policy, angles.begin(), angles.end(), quaternions.begin()));
+    EXPECT_EQ(matrices.end(), toRotationMatrix(policy, angles.begin(), angles.end(), matrices.begin()));
+    for (size_t i = 0; i < angles.size(); i++) {
+      EXPECT_TRUE(equals(toRotationMatrix(toQuaternion(angles[i])), toRotationMatrix(quaternions[i]), error)) << "index " << i;
+      EXPECT_TRUE(equals(toRotationMatrix(angles[i]), matrices[i], error)) << "index " << i;
+    }
+    toQuaternion(policy, matrices.begin(), matrices.end(), quaternions.begin());
+    toEulerAngle(policy, quaternions.begin(), quaternions.end(), EulerOrder::ZXY, back.begin());
+    for (size_t i = 0; i < angles.size(); i++) {
+      EXPECT_EQ(EulerOrder::ZXY, back[i].order);
+      auto expected = toEulerAngle(quaternions[i], EulerOrder::ZXY);
+      EXPECT_TRUE(equals(toRotationMatrix(expected), toRotationMatrix(back[i]), error)) << "index " << i;
+    }
+    toEulerAngle(policy, matrices.begin(), matrices.end(), EulerOrder::XZY, back.begin());
+    for (size_t i = 0; i < angles.size(); i++) {
+      auto expected = toEulerAngle(matrices[i], EulerOrder::XZY);
+      EXPECT_TRUE(equals(toRotationMatrix(expected), toRotationMatrix(back[i]), error)) << "index " << i;
+    }
+  };
+  run(std::execution::seq, 1e-6f);
+  run(std::execution::par, 1e-6f);
+  // par_unseq goes through the SIMD batch kernels.
+  run(std::execution::par_unseq, 1e-4f);
+}
+
+// Invalid orders throw before the algorithm starts instead of escaping it, which would call std::terminate.
+TEST(ExecutionPolicy, RejectsInvalidOrders) {
+  auto invalid = static_cast<EulerOrder>(42);
+  std::vector<EulerAngle> angles(1000, EulerAngle(0.1f, 0.2f, 0.3f, EulerOrder::XYZ));
+  angles[777].order = invalid;
+  std::vector<Quaternion> quaternions(angles.size(), Quaternion(0, 0, 0, 1));
+  std::vector<RotationMatrix> matrices(angles.size(), RotationMatrix::rotationX(0));
+  std::vector<EulerAngle> back(angles.size(), EulerAngle(0, 0, 0, EulerOrder::XYZ));
+  auto run = [&](auto&& policy) {
+    EXPECT_THROW(toEulerAngle(policy, quaternions.begin(), quaternions.end(), invalid, back.begin()), const char*);
+    EXPECT_THROW(toEulerAngle(policy, matrices.begin(), matrices.end(), invalid, back.begin()), const char*);
+    EXPECT_THROW(toQuaternion(policy, angles.begin(), angles.end(), quaternions.begin()), const char*);
+    EXPECT_THROW(toRotationMatrix(policy, angles.begin(), angles.end(), matrices.begin()), const char*);
+  };
+  run(std::execution::par);
+  run(std::execution::par_unseq);
+  // Nothing was written.
+  EXPECT_EQ(0.0f, quaternions[0].x);
+  EXPECT_EQ(1.0f, matrices[0][0]);
+}
+
+TEST(RotationFile, ConvertsInParallel) {
+  std::vector<Quaterniond> quaternions;
+  for (auto i = 0; i < 5000; i++) {
+    quaternions.push_back(toQuaternion(EulerAngled(0.37 * i, 0.011 * i - 3, 1.7 - 0.23 * i, EulerOrder::YXZ)));
+  }
+  auto input = testing::TempDir() + "quaternions.rot";
+  auto output = testing::TempDir() + "angles.rot";
+  writeRotationFile(input.c_str(), quaternions.data(), quaternions.size());
+  ThreadPool pool(3);
+  convertRotationFile(pool, input.c_str(), output.c_str(), RotationKind::EulerAngle, EulerOrder::ZYX);
+  RotationFile file(output.c_str());
+  EXPECT_EQ(RotationKind::EulerAngle, file.header().kind);
+  EXPECT_EQ(sizeof(double), file.header().scalarSize);
+  ASSERT_EQ(quaternions.size(), file.header().count);
+  auto angles = file.records<EulerAngled>();
+  for (size_t i = 0; i < quaternions.size(); i++) {
+    auto expected = toEulerAngle(quaternions[i], EulerOrder::ZYX);
+    ASSERT_EQ(EulerOrder::ZYX, angles[i].order);
+    ASSERT_EQ(expected.x, angles[i].x) << "index " << i;
+    ASSERT_EQ(expected.y, angles[i].y) << "index " << i;
+    ASSERT_EQ(expected.z, angles[i].z) << "index " << i;
+  }
+  EXPECT_THROW(file.records<EulerAngle>(), const char*);
+  EXPECT_THROW(file.records<Quaterniond>(), const char*);
+  EXPECT_THROW(RotationFile(testing::TempDir().c_str()), const char*);
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+TEST(RotationFile, ChecksInputBeforeReplacingOutput) {
+  std::vector<Quaterniond> quaternions(100, toQuaternion(EulerAngled(0.3, -1.2, 2.5, EulerOrder::XZY)));
+  std::vector<Quaternion> kept(3, Quaternion(0, 0, 0, 1));
+  auto input = testing::TempDir() + "checked.rot";
+  auto output = testing::TempDir() + "kept.rot";
+  writeRotationFile(input.c_str(), quaternions.data(), quaternions.size());
+  writeRotationFile(output.c_str(), kept.data(), kept.size());
+  ThreadPool pool(2);
+  EXPECT_THROW(convertRotationFile(pool, input.c_str(), input.c_str(), RotationKind::Quaternion), const char*);
+  EXPECT_EQ(quaternions.size(), RotationFile(input.c_str()).header().count);
+
+  auto fd = open(input.c_str(), O_WRONLY);
+  uint32_t stride = sizeof(Quaternion);
+  ASSERT_EQ(ssize_t(sizeof(stride)), pwrite(fd, &stride, sizeof(stride), offsetof(RotationFileHeader, stride)));
+  close(fd);
+  EXPECT_THROW(convertRotationFile(pool, input.c_str(), output.c_str(), RotationKind::EulerAngle), const char*);
+  EXPECT_EQ(kept.size(), RotationFile(output.c_str()).header().count);
+  for (auto& entry : std::filesystem::directory_iterator(testing::TempDir())) {
+    EXPECT_NE(0u, entry.path().filename().string().rfind("kept.rot.", 0)) << entry.path();
+  }
+
+  auto staged = output + ".tmp";
+  writeRotationFile(staged.c_str(), quaternions.data(), quaternions.size());
+  convertRotationFile(pool, staged.c_str(), output.c_str(), RotationKind::Quaternion);
+  EXPECT_EQ(quaternions.size(), RotationFile(staged.c_str()).header().count);
+  EXPECT_EQ(quaternions[0].w, RotationFile(staged.c_str()).records<Quaterniond>()[0].w);
+  EXPECT_EQ(quaternions.size(), RotationFile(output.c_str()).header().count);
+  std::remove(staged.c_str());
+
+  writeRotationFile(input.c_str(), quaternions.data(), quaternions.size());
+  convertRotationFile(pool, input.c_str(), output.c_str(), RotationKind::EulerAngle, EulerOrder::YZX);
+  MappedFile file(output.c_str());
+  ASSERT_EQ(ROTATION_FILE_DATA_OFFSET + quaternions.size() * sizeof(EulerAngled), file.size());
+  for (size_t i = 0; i < quaternions.size(); i++) {
+    auto record = file.data() + ROTATION_FILE_DATA_OFFSET + i * sizeof(EulerAngled);
+    for (auto j = RotationRecord<EulerAngled>::size; j < sizeof(EulerAngled); j++) {
+      ASSERT_EQ(0, record[j]) << "index " << i;
+    }
+  }
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+template <class P>
+void expectCodecRoundTrip(float error) {
+  std::vector<float> x, y, z, w;
+  for (auto i = 0; i < 1000; i++) {
+    auto q = toQuaternion(EulerAngle(0.37f * i, 0.011f * i - 3, 1.7f - 0.23f * i, EULER_ORDERS[i % 6]));
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  for (auto q : { Quaternion(0, 0, 0, 1), Quaternion(0, 0, 0, -1), Quaternion(1, 0, 0, 0), Quaternion(0.5f, -0.5f, 0.5f, -0.5f),
+      Quaternion(0.70710678f, 0.70710678f, 0, 0) }) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  auto count = x.size();
+  std::vector<P> packed(count);
+  std::vector<float> dx(count), dy(count), dz(count), dw(count);
+  for (auto tier : { simd::Tier::Scalar, simd::Tier::Sse41, simd::Tier::Avx2, simd::Tier::Avx512 }) {
+    simd::setTier(tier);
+    encodeQuaternionBatch(x.data(), y.data(), z.data(), w.data(), count, packed.data());
+    decodeQuaternionBatch(packed.data(), count, dx.data(), dy.data(), dz.data(), dw.data());
+    for (size_t i = 0; i < count; i++) {
+      auto q = Quaternion(x[i], y[i], z[i], w[i]);
+      auto decoded = Quaternion(dx[i], dy[i], dz[i], dw[i]);
+      EXPECT_TRUE(equals(toRotationMatrix(q), toRotationMatrix(decoded), error)) << "tier " << static_cast<int>(tier) << ", index " << i;
+      auto scalar = decodeQuaternion(encodeQuaternion<P>(q));
+      EXPECT_TRUE(equals(toRotationMatrix(scalar), toRotationMatrix(decoded), error)) << "tier " << static_cast<int>(tier) << ", index " << i;
+    }
+  }
+  simd::setTier(simd::supportedTier());
+}
+
+TEST(QuaternionCodec, RoundTrip) {
+  EXPECT_EQ(4u, sizeof(PackedQuaternion32));
+  EXPECT_EQ(6u, sizeof(PackedQuaternion48));
+  expectCodecRoundTrip<PackedQuaternion32>(4e-3f);
+  expectCodecRoundTrip<PackedQuaternion48>(1.5e-4f);
+  auto identity = decodeQuaternion(encodeQuaternion48(Quaternion(0, 0, 0, -2)));
+  EXPECT_NEAR(0.0f, identity.x, 3e-5f);
+  EXPECT_NEAR(1.0f, identity.w, 1e-6f);
+}
+
+TEST(SpanConversion, MatchesByValue) {
+  std::vector<EulerAngle> angles;
+  for (auto i = 0; i < 300; i++) {
+    angles.push_back(EulerAngle(0.37f * i, 0.011f * i - 3, 1.7f - 0.23f * i, EULER_ORDERS[i % 6]));
+  }
+  std::vector<Quaternion> quaternions(angles.size(), Quaternion(0, 0, 0, 1));
+  std::vector<RotationMatrix> matrices(angles.size(), RotationMatrix::rotationX(0));
+  std::vector<EulerAngle> fromQuaternions(angles.size(), EulerAngle(0, 0, 0, EulerOrder::XYZ));
+  std::vector<EulerAngle> fromMatrices(angles.size(), EulerAngle(0, 0, 0, EulerOrder::XYZ));
+  std::vector<Quaternion> fromMatrix(angles.size(), Quaternion(0, 0, 0, 1));
+  std::vector<RotationMatrix> fromQuaternion(angles.size(), RotationMatrix::rotationX(0));
+  toQuaternion(angles, quaternions);
+  toRotationMatrix(angles, matrices);
+  toEulerAngle(quaternions, EulerOrder::YZX, fromQuaternions);
+  toEulerAngle(matrices, EulerOrder::ZXY, fromMatrices);
+  toQuaternion(matrices, fromMatrix);
+  toRotationMatrix(quaternions, fromQuaternion);
+  // Same arithmetic as the by-value conversions, so the results are bitwise identical.
+  auto same = [](const auto& a, const auto& b) { return std::memcmp(&a, &b, sizeof(a)) == 0; };
+  for (size_t i = 0; i < angles.size(); i++) {
+    EXPECT_TRUE(same(toQuaternion(angles[i]), quaternions[i])) << "index " << i;
+    EXPECT_TRUE(same(toRotationMatrix(angles[i]), matrices[i])) << "index " << i;
+    EXPECT_TRUE(same(toEulerAngle(quaternions[i], EulerOrder::YZX), fromQuaternions[i])) << "index " << i;
+    EXPECT_TRUE(same(toEulerAngle(matrices[i], EulerOrder::ZXY), fromMatrices[i])) << "index " << i;
+    EXPECT_TRUE(same(toQuaternion(matrices[i]), fromMatrix[i])) << "index " << i;
+    EXPECT_TRUE(same(toRotationMatrix(quaternions[i]), fromQuaternion[i])) << "index " << i;
+  }
+  std::span<Quaternion> tooSmall(quaternions.data(), 10);
+  EXPECT_THROW(toQuaternion(angles, tooSmall), const char*);
+}
+
+TEST(ConstexprConversion, MatchesRuntime) {
+  constexpr auto angle = EulerAngled(0.3, -1.1, 1.2, EulerOrder::YZX);
+  constexpr auto q = toQuaternion<EulerOrder::YZX>(angle);
+  constexpr auto m = toRotationMatrix<EulerOrder::YZX>(angle);
+  constexpr auto fromQuaternion = toEulerAngle<EulerOrder::YZX>(q);
+  constexpr auto fromMatrix = toEulerAngle<EulerOrder::YZX>(m);
+  constexpr auto fromMatrixQuaternion = toQuaternion(m);
+  static_assert(constexprMath::abs(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w - 1) < 1e-14);
+  static_assert(constexprMath::abs(fromQuaternion.y + 1.1) < 1e-12);
+  auto runtimeAngle = angle;
+  auto runtimeQ = toQuaternion(runtimeAngle);
+  auto runtimeM = toRotationMatrix(runtimeAngle);
+  EXPECT_NEAR(runtimeQ.x, q.x, 1e-14);
+  EXPECT_NEAR(runtimeQ.y, q.y, 1e-14);
+  EXPECT_NEAR(runtimeQ.z, q.z, 1e-14);
+  EXPECT_NEAR(runtimeQ.w, q.w, 1e-14);
+  for (size_t i = 0; i < 9; i++) {
+    EXPECT_NEAR(runtimeM[i], m[i], 1e-14);
+  }
+  EXPECT_NEAR(0.3, fromQuaternion.x, 1e-12);
+  EXPECT_NEAR(1.2, fromQuaternion.z, 1e-12);
+  EXPECT_NEAR(0.3, fromMatrix.x, 1e-12);
+  EXPECT_NEAR(-1.1, fromMatrix.y, 1e-12);
+  EXPECT_NEAR(1.2, fromMatrix.z, 1e-12);
+  EXPECT_NEAR(q.w, fromMatrixQuaternion.w, 1e-14);
+  for (auto x = -40.0; x < 40; x += 0.37) {
+    EXPECT_NEAR(std::sin(x), constexprMath::seriesSin(x), 1e-14);
+    EXPECT_NEAR(std::cos(x), constexprMath::seriesCos(x), 1e-14);
+    EXPECT_NEAR(std::atan2(std::sin(x), std::cos(x)), constexprMath::seriesAtan2(std::sin(x), std::cos(x)), 1e-14);
+  }
+}
+
+TEST(ConversionError, ReportsInvalidOrder) {
+  auto invalid = static_cast<EulerOrder>(6);
+  auto e = EulerAngle(0.1f, 0.2f, 0.3f, EulerOrder::ZXY);
+  auto q = Quaternion(0, 0, 0, 1);
+  auto m = RotationMatrix::rotationX(0);
+  static_assert(noexcept(tryToEulerAngle(q, invalid, e)));
+  EXPECT_EQ(ConversionError::InvalidEulerOrder, tryToEulerAngle(q, invalid, e));
+  EXPECT_EQ(ConversionError::InvalidEulerOrder, tryToEulerAngle(m, invalid, e));
+  EXPECT_EQ(0.1f, e.x);
+  EXPECT_EQ(ConversionError::None, tryToQuaternion(e, q));
+  EXPECT_EQ(ConversionError::None, tryToRotationMatrix(e, m));
+  EXPECT_EQ(toQuaternion(e).x, q.x);
+  EXPECT_EQ(toRotationMatrix(e)[5], m[5]);
+  EXPECT_EQ(ConversionError::None, tryToEulerAngle(q, EulerOrder::ZXY, e));
+  EXPECT_NEAR(0.3f, e.z, 1e-6f);
+  e.order = invalid;
+  EXPECT_EQ(ConversionError::InvalidEulerOrder, tryToQuaternion<TrigPrecision::Fast>(e, q));
+  EXPECT_EQ(ConversionError::InvalidEulerOrder, tryToRotationMatrix(e, m));
+  EXPECT_THROW(toQuaternion(e), const char*);
+}
+
+TEST(SinCosTable, MatchesExact) {
+  // 0.01 degree grid: 1152000 bytes interleaved, 144008 bytes as a quarter table.
+  SinCosTabled interleaved(36000, 2000000);
+  SinCosTabled quarter(36000, 200000);
+  EXPECT_EQ(1152000u, interleaved.memoryUsage());
+  EXPECT_EQ(144008u, quarter.memoryUsage());
+  EXPECT_THROW(SinCosTabled(36000, 1000), const char*);
+  for (auto i = -80000; i < 80000; i += 7) {
+    auto angle = i * 0.01 * constexprMath::PI / 180;
+    for (const auto* table : { &interleaved, &quarter }) {
+      double s, c;
+      table->halfSinCos(angle, s, c);
+      EXPECT_NEAR(std::sin(0.5 * angle), s, 1e-14) << "step " << i;
+      EXPECT_NEAR(std::cos(0.5 * angle), c, 1e-14) << "step " << i;
+      // Off the grid, computed exactly.
+      table->halfSinCos(angle + 3e-5, s, c);
+      EXPECT_EQ(std::sin(0.5 * (angle + 3e-5)), s) << "step " << i;
+    }
+  }
+  for (auto order : EULER_ORDERS) {
+    auto e = EulerAngled(12.34 * constexprMath::PI / 180, -87.65 * constexprMath::PI / 180,
+      179.99 * constexprMath::PI / 180, order);
+    auto expected = toQuaternion(e);
+    auto q = toQuaternion(e, quarter);
+    EXPECT_NEAR(expected.x, q.x, 1e-14);
+    EXPECT_NEAR(expected.y, q.y, 1e-14);
+    EXPECT_NEAR(expected.z, q.z, 1e-14);
+    EXPECT_NEAR(expected.w, q.w, 1e-14);
+  }
+}
+
+TEST(SinCosTable, FallsBackForNonFiniteAngles) {
+  SinCosTabled interleaved(36000, 2000000);
+  SinCosTabled quarter(36000, 200000);
+  auto infinity = std::numeric_limits<double>::infinity();
+  for (const auto* table : { &interleaved, &quarter }) {
+    for (auto angle : { std::numeric_limits<double>::quiet_NaN(), infinity, -infinity }) {
+      double s, c;
+      table->halfSinCos(angle, s, c);
+      EXPECT_TRUE(std::isnan(s)) << angle;
+      EXPECT_TRUE(std::isnan(c)) << angle;
+    }
+    for (auto angle : { 1e30, -1e30 }) {
+      double s, c;
+      table->halfSinCos(angle, s, c);
+      EXPECT_EQ(std::sin(0.5 * angle), s) << angle;
+      EXPECT_EQ(std::cos(0.5 * angle), c) << angle;
+    }
+  }
+}
+
+TEST(EulerAngleCache, CountsHits) {
+  EulerAngleCache cache(100);
+  EXPECT_EQ(128u, cache.capacity());
+  std::vector<Quaternion> quaternions;
+  for (auto i = 0; i < 50; i++) {
+    quaternions.push_back(toQuaternion(EulerAngle(0.37f * i, 0.011f * i - 0.3f, 1.7f - 0.23f * i, EulerOrder::XYZ)));
+  }
+  for (auto pass = 0; pass < 3; pass++) {
+    for (const auto& q : quaternions) {
+      auto e = cache.toEulerAngle(q, EulerOrder::ZXY);
+      auto expected = toEulerAngle(q, EulerOrder::ZXY);
+      EXPECT_EQ(expected.x, e.x);
+      EXPECT_EQ(expected.y, e.y);
+      EXPECT_EQ(expected.z, e.z);
+      EXPECT_EQ(EulerOrder::ZXY, e.order);
+    }
+  }
+  EXPECT_EQ(50u, cache.misses());
+  EXPECT_EQ(100u, cache.hits());
+  // The negated quaternion is the same key, another order is not.
+  auto q = quaternions[7];
+  cache.resetCounters();
+  cache.toEulerAngle(Quaternion(-q.x, -q.y, -q.z, -q.w), EulerOrder::ZXY);
+  cache.toEulerAngle(q, EulerOrder::YXZ);
+  EXPECT_EQ(1u, cache.hits());
+  EXPECT_EQ(1u, cache.misses());
+  EXPECT_THROW(cache.toEulerAngle(q, static_cast<EulerOrder>(6)), const char*);
+  toEulerAngleCached(q, EulerOrder::XZY);
+  toEulerAngleCached(q, EulerOrder::XZY);
+  EXPECT_EQ(1u, threadEulerAngleCache<float>().hits());
+}
+
+TEST(EulerAngleStream, IsContinuous) {
+  for (auto order : EULER_ORDERS) {
+    // Winds the outer angles over several turns while the middle one runs into gimbal lock twice.
+    std::vector<Quaterniond> quaternions;
+    std::vector<EulerAngled> expected;
+    std::vector<double> middles;
+    for (auto i = 0; i < 2000; i++) {
+      auto t = 0.01 * i;
+      auto middle = std::max(-0.5 * PI, 1.4 * std::sin(0.7 * t) - 0.3);
+      middles.push_back(middle);
+      double angles[] = { 3 * t, middle, -2 * t + 1 };
+      double fields[3];
+      static const size_t axes[][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+      for (size_t j = 0; j < 3; j++) {
+        fields[axes[static_cast<size_t>(order)][j]] = angles[j];
+      }
+      expected.push_back(EulerAngled(fields[0], fields[1], fields[2], order));
+      quaternions.push_back(toQuaternion(expected.back()));
+    }
+    std::vector<EulerAngled> angles(quaternions.size(), EulerAngled(0, 0, 0, order));
+    toEulerAngleStream(quaternions.data(), quaternions.size(), order, angles.data());
+    for (size_t i = 0; i < angles.size(); i++) {
+      auto q = toQuaternion(angles[i]);
+      auto dot = q.x * quaternions[i].x + q.y * quaternions[i].y + q.z * quaternions[i].z + q.w * quaternions[i].w;
+      EXPECT_NEAR(1.0, std::abs(dot), 1e-5) << "frame " << i;
+      // Leaving the lock, the outer angles jump back to the split that lock could not observe.
+      if (i > 0 && std::abs(std::abs(middles[i - 1]) - 0.5 * PI) > 0.005) {
+        EXPECT_LT(std::abs(angles[i].x - angles[i - 1].x), 0.1) << "frame " << i;
+        EXPECT_LT(std::abs(angles[i].y - angles[i - 1].y), 0.1) << "frame " << i;
+        EXPECT_LT(std::abs(angles[i].z - angles[i - 1].z), 0.1) << "frame " << i;
+      }
+      // Until the first lock the unwrapped angles are the original ones.
+      if (i < 600) {
+        EXPECT_NEAR(expected[i].x, angles[i].x, 1e-6) << "frame " << i;
+        EXPECT_NEAR(expected[i].y, angles[i].y, 1e-6) << "frame " << i;
+        EXPECT_NEAR(expected[i].z, angles[i].z, 1e-6) << "frame " << i;
+      }
+    }
+  }
+}
+
+TEST(EulerAngleStream, DetectsGimbalLockLikeTheConversion) {
+  // Field index of the middle angle for each order.
+  const size_t middleAxes[] = { 1, 2, 0, 2, 0, 1 };
+  for (auto order : EULER_ORDERS) {
+    withEulerOrder(order, [&](auto o) {
+      for (auto middle : { 0.5 * PI, -0.5 * PI, 0.5 * PI - 1e-4, 1.5, -0.3 }) {
+        EulerAngled e(0.2, 0.2, 0.2, order);
+        (&e.x)[middleAxes[static_cast<size_t>(order)]] = middle;
+        auto locked = std::abs(middle) > 1.55;
+        EXPECT_EQ(locked, isGimbalLocked<decltype(o)::value>(toQuaternion(e))) << "middle " << middle;
+        EXPECT_EQ(locked, isGimbalLocked<decltype(o)::value>(toRotationMatrix(e))) << "middle " << middle;
+      }
+    });
+  }
+}
+
+TEST(Interpolation, TakesShortestPath) {
+  auto a = Quaternion::rotationZ(0.2f);
+  auto b = Quaternion::rotationZ(1.8f);
+  auto negated = Quaternion(-b.x, -b.y, -b.z, -b.w);
+  for (auto t : { 0.0f, 0.25f, 0.5f, 1.0f }) {
+    auto expected = Quaternion::rotationZ(0.2f + 1.6f * t);
+    auto q = slerp(a, negated, t);
+    EXPECT_NEAR(1.0f, std::abs(dot(expected, q)), 1e-6f) << "t " << t;
+    EXPECT_NEAR(1.0f, std::abs(dot(expected, slerp(a, b, t))), 1e-6f) << "t " << t;
+    EXPECT_NEAR(1.0f, std::abs(dot(toQuaternion(EulerAngle(0, 0, 0.2f + 1.6f * t, EulerOrder::XYZ)), q)), 1e-6f);
+  }
+  auto mid = nlerp(a, negated, 0.5f);
+  EXPECT_NEAR(1.0f, std::abs(dot(Quaternion::rotationZ(1.0f), mid)), 1e-6f);
+  // Nearly parallel keys fall back to nlerp.
+  auto close = slerp(a, Quaternion::rotationZ(0.2001f), 0.5f);
+  EXPECT_NEAR(1.0f, std::abs(dot(Quaternion::rotationZ(0.20005f), close)), 1e-6f);
+}
+
+TEST(Interpolation, BatchMatchesScalar) {
+  const size_t count = 301;
+  std::vector<float> ax, ay, az, aw, bx, by, bz, bw, t;
+  for (size_t i = 0; i < count; i++) {
+    auto a = toQuaternion(EulerAngle(0.37f * i, 0.011f * i - 1, 1.7f - 0.23f * i, EulerOrder::XYZ));
+    auto b = toQuaternion(EulerAngle(0.17f * i, 0.5f - 0.013f * i, 0.29f * i, EulerOrder::ZXY));
+    if (i % 5 == 0) {
+      b = a;
+    }
+    ax.push_back(a.x); ay.push_back(a.y); az.push_back(a.z); aw.push_back(a.w);
+    bx.push_back(b.x); by.push_back(b.y); bz.push_back(b.z); bw.push_back(b.w);
+    t.push_back(static_cast<float>(i % 11) / 10);
+  }
+  for (auto mode : { Interpolation::Slerp, Interpolation::Nlerp }) {
+    std::vector<float> x(count), y(count), z(count), w(count), elements(9 * count);
+    interpolateBatch(mode, ax.data(), ay.data(), az.data(), aw.data(), bx.data(), by.data(), bz.data(), bw.data(),
+      t.data(), count, x.data(), y.data(), z.data(), w.data());
+    interpolateBatch(mode, ax.data(), ay.data(), az.data(), aw.data(), bx.data(), by.data(), bz.data(), bw.data(),
+      t.data(), count, elements.data());
+    for (size_t i = 0; i < count; i++) {
+      auto a = Quaternion(ax[i], ay[i], az[i], aw[i]);
+      auto b = Quaternion(bx[i], by[i], bz[i], bw[i]);
+      auto expected = mode == Interpolation::Slerp ? slerp(a, b, t[i]) : nlerp(a, b, t[i]);
+      EXPECT_NEAR(expected.x, x[i], 2e-6f) << "index " << i;
+      EXPECT_NEAR(expected.y, y[i], 2e-6f) << "index " << i;
+      EXPECT_NEAR(expected.z, z[i], 2e-6f) << "index " << i;
+      EXPECT_NEAR(expected.w, w[i], 2e-6f) << "index " << i;
+      auto m = toRotationMatrix(expected);
+      for (size_t j = 0; j < 9; j++) {
+        EXPECT_NEAR(m[j], elements[9 * i + j], 4e-6f) << "index " << i;
+      }
+    }
+  }
+}
+
+TEST(Interpolation, SamplesTracks) {
+  const float times[] = { 0, 1, 3 };
+  const Quaternion keys[] = { Quaternion::rotationX(0), Quaternion::rotationX(1), Quaternion::rotationX(2) };
+  std::vector<QuaternionTrack> tracks;
+  for (size_t i = 0; i < 40; i++) {
+    tracks.push_back(QuaternionTrack{ times, keys, 1 + i % 3 });
+  }
+  std::vector<RotationMatrix> matrices(tracks.size(), RotationMatrix::rotationX(0));
+  for (auto time : { -1.0f, 0.5f, 2.0f, 5.0f }) {
+    std::vector<float> x(tracks.size()), y(tracks.size()), z(tracks.size()), w(tracks.size());
+    sampleTracks(tracks.data(), tracks.size(), time, Interpolation::Slerp, x.data(), y.data(), z.data(), w.data());
+    sampleTracks(tracks.data(), tracks.size(), time, Interpolation::Slerp, matrices.data());
+    for (size_t i = 0; i < tracks.size(); i++) {
+      auto last = static_cast<float>(tracks[i].count - 1);
+      auto angle = std::clamp(time < 1 ? time : 1 + (time - 1) / 2, 0.0f, last);
+      auto expected = Quaternion::rotationX(angle);
+      EXPECT_NEAR(1.0f, std::abs(dot(expected, Quaternion(x[i], y[i], z[i], w[i]))), 1e-6f) << "track " << i;
+      EXPECT_NEAR(std::cos(angle), matrices[i].at(1, 1), 1e-5f) << "track " << i;
+    }
+  }
+  QuaternionTrack empty{ times, keys, 0 };
+  float x, y, z, w;
+  EXPECT_THROW(sampleTracks(&empty, 1, 0, Interpolation::Nlerp, &x, &y, &z, &w), const char*);
+}
+
+TEST(TrackResampling, MatchesPerFrameSlerp) {
+  std::vector<std::vector<float>> times;
+  std::vector<std::vector<EulerAngle>> keys;
+  for (size_t i = 0; i < 7; i++) {
+    times.emplace_back();
+    keys.emplace_back();
+    auto keyCount = 1 + 3 * i;
+    for (size_t k = 0; k < keyCount; k++) {
+      times.back().push_back(0.5f + 0.37f * k + 0.05f * (k % 3));
+      keys.back().push_back(EulerAngle(0.9f * k, 0.4f * k - 1, 2.1f * k + i, EULER_ORDERS[i % 6]));
+    }
+  }
+  std::vector<EulerAngleTrack> tracks;
+  for (size_t i = 0; i < times.size(); i++) {
+    tracks.push_back(EulerAngleTrack{ times[i].data(), keys[i].data(), times[i].size() });
+  }
+  auto rate = 30.0f;
+  auto offsets = resampledTrackOffsets(tracks.data(), tracks.size(), rate);
+  EXPECT_EQ(1u, offsets[1]);
+  std::vector<Quaternion> sequential(offsets.back(), Quaternion(0, 0, 0, 1));
+  std::vector<Quaternion> parallel(offsets.back(), Quaternion(0, 0, 0, 1));
+  ThreadPool one(1);
+  ThreadPool three(3);
+  resampleTracks(one, tracks.data(), tracks.size(), rate, Interpolation::Slerp, offsets.data(), sequential.data());
+  resampleTracks(three, tracks.data(), tracks.size(), rate, Interpolation::Slerp, offsets.data(), parallel.data());
+  EXPECT_EQ(0, std::memcmp(sequential.data(), parallel.data(), sequential.size() * sizeof(Quaternion)));
+  for (size_t i = 0; i < tracks.size(); i++) {
+    const auto& track = tracks[i];
+    for (auto frame = offsets[i]; frame < offsets[i + 1]; frame++) {
+      auto time = track.times[0] + (frame - offsets[i]) / rate;
+      auto next = static_cast<size_t>(std::upper_bound(track.times, track.times + track.count, time) - track.times);
+      auto previous = next == 0 ? 0 : next - 1;
+      next = std::min(next, track.count - 1);
+      auto t = next == previous ? 0 : (time - track.times[previous]) / (track.times[next] - track.times[previous]);
+      auto expected = slerp(toQuaternion(track.keys[previous]), toQuaternion(track.keys[next]), t);
+      EXPECT_NEAR(1.0f, std::abs(dot(expected, sequential[frame])), 1e-5f) << "track " << i << " frame " << frame;
+      // Consecutive frames stay in one hemisphere.
+      if (frame > offsets[i]) {
+        EXPECT_GT(dot(sequential[frame - 1], sequential[frame]), 0.0f) << "track " << i << " frame " << frame;
+      }
+    }
+  }
+}
+
+TEST(Hierarchy, MatchesChainedProducts) {
+  // Two roots, branches and a chain, each parent before its children.
+  const int32_t parents[] = { NO_PARENT, 0, 1, 1, 0, 4, NO_PARENT, 6, 7, 8, 7, 2, 11, 12, 3, 14, 5, 16, 9 };
+  const size_t jointCount = sizeof(parents) / sizeof(parents[0]);
+  const size_t instanceCount = 37;
+  std::vector<Quaternion> local;
+  std::vector<RotationMatrix> localMatrices;
+  for (size_t j = 0; j < jointCount; j++) {
+    local.push_back(toQuaternion(EulerAngle(0.3f * j, 0.7f - 0.2f * j, 1.1f * j, EulerOrder::ZXY)));
+    localMatrices.push_back(toRotationMatrix(local.back()));
+  }
+  std::vector<Quaternion> world(jointCount, local[0]);
+  std::vector<RotationMatrix> worldMatrices(jointCount, localMatrices[0]);
+  composeHierarchy(local.data(), parents, jointCount, world.data());
+  composeHierarchy(localMatrices.data(), parents, jointCount, worldMatrices.data());
+  for (size_t j = 0; j < jointCount; j++) {
+    auto expected = local[j];
+    for (auto parent = parents[j]; parent != NO_PARENT; parent = parents[parent]) {
+      expected = local[parent] * expected;
+    }
+    EXPECT_NEAR(1.0f, std::abs(dot(expected, world[j])), 1e-5f) << "joint " << j;
+    auto m = toRotationMatrix(expected);
+    for (size_t i = 0; i < 9; i++) {
+      EXPECT_NEAR(m[i], worldMatrices[j][i], 1e-5f) << "joint " << j << " element " << i;
+    }
+  }
+
+  // Instance i rotates every local rotation by a different angle; the batch runs in place.
+  std::vector<float> x(jointCount * instanceCount), y(x.size()), z(x.size()), w(x.size());
+  for (size_t j = 0; j < jointCount; j++) {
+    for (size_t i = 0; i < instanceCount; i++) {
+      auto q = local[j] * Quaternion::rotationY(0.1f * i);
+      x[j * instanceCount + i] = q.x;
+      y[j * instanceCount + i] = q.y;
+      z[j * instanceCount + i] = q.z;
+      w[j * instanceCount + i] = q.w;
+    }
+  }
+  auto px = x, py = y, pz = z, pw = w;
+  composeHierarchyBatch(parents, jointCount, instanceCount, x.data(), y.data(), z.data(), w.data(),
+    x.data(), y.data(), z.data(), w.data());
+  ThreadPool pool(3);
+  composeHierarchyBatch(pool, parents, jointCount, instanceCount, px.data(), py.data(), pz.data(), pw.data(),
+    px.data(), py.data(), pz.data(), pw.data());
+  EXPECT_EQ(x, px);
+  EXPECT_EQ(w, pw);
+  for (size_t i = 0; i < instanceCount; i++) {
+    std::vector<Quaternion> instanceLocal, instanceWorld(jointCount, local[0]);
+    for (size_t j = 0; j < jointCount; j++) {
+      instanceLocal.push_back(local[j] * Quaternion::rotationY(0.1f * i));
+    }
+    composeHierarchy(instanceLocal.data(), parents, jointCount, instanceWorld.data());
+    for (size_t j = 0; j < jointCount; j++) {
+      auto k = j * instanceCount + i;
+      EXPECT_NEAR(1.0f, std::abs(dot(instanceWorld[j], Quaternion(x[k], y[k], z[k], w[k]))), 1e-5f)
+        << "instance " << i << " joint " << j;
+    }
+  }
+
+  const int32_t unsorted[] = { NO_PARENT, 2, 0 };
+  EXPECT_ANY_THROW(composeHierarchy(local.data(), unsorted, 3, world.data()));
+}
+
+TEST(Orthonormalization, RemovesDrift) {
+  // Perturbations up to 0.1 of rotations, plus one long chain of products.
+  std::vector<RotationMatrix> matrices;
+  for (size_t i = 0; i < 37; i++) {
+    auto m = toRotationMatrix(EulerAngle(0.3f * i, 0.7f - 0.05f * i, 1.1f * i, EULER_ORDERS[i % 6]));
+    for (size_t k = 0; k < 9; k++) {
+      m[k] += 0.1f * std::sin(1.7f * i + 2.3f * k) * (i % 5) / 4;
+    }
+    matrices.push_back(m);
+  }
+  auto chain = RotationMatrix::rotationX(0);
+  for (size_t i = 0; i < 100000; i++) {
+    chain = chain * RotationMatrix::rotationY(0.01f + 0.001f * (i % 7));
+  }
+  matrices.push_back(chain);
+  EXPECT_GT(orthonormalityDrift(chain), 1e-5f);
+
+  std::vector<float> drift(matrices.size());
+  orthonormalityDriftBatch(matrices.data(), matrices.size(), drift.data());
+  for (auto mode : { Orthonormalization::GramSchmidt, Orthonormalization::Polar }) {
+    auto result = matrices;
+    std::vector<float> reported(matrices.size());
+    orthonormalizeBatch(mode, result.data(), result.size(), result.data(), reported.data());
+    EXPECT_EQ(drift, reported);
+    for (size_t i = 0; i < matrices.size(); i++) {
+      EXPECT_NEAR(orthonormalityDrift(matrices[i]), drift[i], 1e-6f) << i;
+      auto expected = orthonormalize(matrices[i], mode);
+      EXPECT_LT(orthonormalityDrift(expected), 1e-6f) << i;
+      EXPECT_LT(orthonormalityDrift(result[i]), 1e-6f) << i;
+      // A rotation, not a reflection: the third column is the cross product of the first two.
+      const auto& e = result[i].elements;
+      EXPECT_NEAR(e[1] * e[5] - e[2] * e[4], e[6], 1e-6f) << i;
+      EXPECT_NEAR(e[2] * e[3] - e[0] * e[5], e[7], 1e-6f) << i;
+      EXPECT_NEAR(e[0] * e[4] - e[1] * e[3], e[8], 1e-6f) << i;
+      for (size_t k = 0; k < 9; k++) {
+        EXPECT_NEAR(expected[k], result[i][k], 1e-6f) << i;
+      }
+      if (mode == Orthonormalization::GramSchmidt) {
+        auto length = std::sqrt(matrices[i][0] * matrices[i][0] + matrices[i][1] * matrices[i][1] +
+          matrices[i][2] * matrices[i][2]);
+        EXPECT_NEAR(matrices[i][0] / length, result[i][0], 1e-6f) << i;
+      }
+    }
+  }
+
+  // The polar decomposition of a symmetric positive definite stretch of a rotation is the rotation.
+  auto r = toRotationMatrix(EulerAngle(0.4f, -1.2f, 2.5f, EulerOrder::YZX));
+  auto stretched = r * RotationMatrix({ 1.05f, 0.02f, 0, 0.02f, 0.97f, 0.01f, 0, 0.01f, 1.03f });
+  auto nearest = orthonormalize(stretched, Orthonormalization::Polar);
+  for (size_t k = 0; k < 9; k++) {
+    EXPECT_NEAR(r[k], nearest[k], 1e-6f);
+  }
+}
+
+TEST(QuaternionNormalization, CanonicalizesInOnePass) {
+  // Scaled rotations with both signs of w, including w = 0 and w = -0.
+  std::vector<Quaternion> quaternions;
+  for (size_t i = 0; i < 37; i++) {
+    auto q = toQuaternion(EulerAngle(0.3f * i, 0.7f - 0.05f * i, 1.1f * i, EULER_ORDERS[i % 6]));
+    auto scale = (i % 2 ? -1 : 1) * (0.5f + 0.1f * i);
+    quaternions.push_back(Quaternion(scale * q.x, scale * q.y, scale * q.z, scale * q.w));
+  }
+  quaternions.push_back(Quaternion(0.6f, 0, 0.8f, 0));
+  quaternions.push_back(Quaternion(0.6f, 0, 0.8f, -0.0f));
+  auto exact = [](const Quaternion q) { return canonicalize(normalize(q)); };
+  EXPECT_EQ(0.0f, canonicalize(Quaternion(0.6f, 0, 0.8f, -0.0f)).w);
+  EXPECT_FALSE(std::signbit(canonicalize(Quaternion(0.6f, 0, 0.8f, -0.0f)).w));
+
+  std::vector<float> x, y, z, w;
+  for (auto q : quaternions) {
+    x.push_back(q.x);
+    y.push_back(q.y);
+    z.push_back(q.z);
+    w.push_back(q.w);
+  }
+  normalizeBatch(x.data(), y.data(), z.data(), w.data(), x.size(), x.data(), y.data(), z.data(), w.data());
+  auto packed = quaternions;
+  normalizeBatch(packed.data(), packed.size(), packed.data());
+  std::vector<Quaternion> kept(quaternions.size(), Quaternion(0, 0, 0, 1));
+  normalizeBatch(quaternions.data(), quaternions.size(), kept.data(), false);
+  for (size_t i = 0; i < quaternions.size(); i++) {
+    auto expected = exact(quaternions[i]);
+    Quaternion results[] = { Quaternion(x[i], y[i], z[i], w[i]), packed[i] };
+    for (auto q : results) {
+      EXPECT_FALSE(std::signbit(q.w)) << i;
+      EXPECT_NEAR(expected.x, q.x, 5e-7f) << i;
+      EXPECT_NEAR(expected.y, q.y, 5e-7f) << i;
+      EXPECT_NEAR(expected.z, q.z, 5e-7f) << i;
+      EXPECT_NEAR(expected.w, q.w, 5e-7f) << i;
+    }
+    // Without canonicalization, the sign is kept.
+    EXPECT_NEAR(1.0f, dot(normalize(quaternions[i]), kept[i]), 1e-6f) << i;
+  }
+}
+
+std::string readAll(FILE* file) {
+  std::string text;
+  char buffer[4096];
+  std::rewind(file);
+  for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file)) != 0;) {
+    text.append(buffer, read);
+  }
+  std::fclose(file);
+  return text;
+}
+
+// Runs the convert command line on input and returns its exit status, filling output and error with what it wrote.
+int runConvert(std::vector<std::string> args, const std::string& input, std::string& output, std::string& error) {
+  args.insert(args.begin(), "convert");
+  std::vector<char*> argv;
+  for (auto& arg : args) {
+    argv.push_back(arg.data());
+  }
+  auto in = std::tmpfile(), out = std::tmpfile(), err = std::tmpfile();
+  std::fwrite(input.data(), 1, input.size(), in);
+  std::rewind(in);
+  auto status = convertMain(static_cast<int>(argv.size()), argv.data(), in, out, err);
+  std::fclose(in);
+  output = readAll(out);
+  error = readAll(err);
+  return status;
+}
+
+std::vector<float> numbers(const std::string& text) {
+  std::vector<float> values;
+  for (auto p = text.c_str(); *p != '\0';) {
+    char* end;
+    auto value = std::strtof(p, &end);
+    if (end == p) {
+      p++;
+    } else {
+      values.push_back(value);
+      p = end;
+    }
+  }
+  return values;
+}
+
+TEST(ConvertCli, RoundTripsCsvAndJson) {
+  std::string csv = "0.1,2.3,-0.7\n1.2,-2.9,0.4\n-3,0.25,1.2\n";
+  std::string json = "[\n  [0.1, 2.3, -0.7],\n  [1.2, -2.9, 0.4],\n  [-3, 0.25, 1.2]\n]\n";
+  std::string quaternions, fromJson, angles, error;
+  ASSERT_EQ(0, runConvert({ "--from", "euler", "--to", "quaternion", "--order", "YZX", "--threads", "2" }, csv,
+    quaternions, error));
+  EXPECT_EQ("", error);
+  ASSERT_EQ(0, runConvert({ "--from", "euler", "--to", "quaternion", "--order", "YZX", "--threads", "2" }, json,
+    fromJson, error));
+  EXPECT_EQ(quaternions, fromJson);
+  ASSERT_EQ(0, runConvert({ "--from", "quaternion", "--to", "euler", "--order", "YZX" }, quaternions, angles, error));
+  auto expected = numbers(csv), actual = numbers(angles);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_NEAR(expected[i], actual[i], 1e-5f) << "index " << i;
+  }
+  EXPECT_EQ(3, std::count(quaternions.begin(), quaternions.end(), '\n'));
+  EXPECT_EQ(12u, numbers(quaternions).size());
+}
+
+TEST(ConvertCli, SkipsHeaderLines) {
+  std::string input = "m00,m01,m02,m10,m11,m12,m20,m21,m22\n\n1,0,0,0,1,0,0,0,1\n";
+  std::string output, error;
+  ASSERT_EQ(0, runConvert({ "--from", "matrix", "--to", "quaternion" }, input, output, error));
+  EXPECT_EQ("0,0,0,1\n", output);
+  ASSERT_EQ(0, runConvert({ "--from", "euler", "--to", "euler" }, "x,y,z\n0.5,0,-1\n", output, error));
+  EXPECT_EQ("0.5,0,-1\n", output);
+}
+
+TEST(ConvertCli, ReportsLineOfBadInput) {
+  std::string output, error;
+  EXPECT_EQ(1, runConvert({ "--from", "euler", "--to", "euler" }, "x,y,z\n0,0,0\n1,2\n3,4,5\n", output, error));
+  EXPECT_EQ("0,0,0\n", output);
+  EXPECT_EQ("convert: line 3: too few numbers\n", error);
+  EXPECT_EQ(1, runConvert({ "--from", "quaternion", "--to", "euler" }, "0,0,0,1,2\n", output, error));
+  EXPECT_EQ("convert: line 1: too many numbers\n", error);
+  EXPECT_EQ(2, runConvert({ "--from", "rotor" }, "", output, error));
+  EXPECT_EQ(USAGE, error);
+}
+
+TEST(ConvertCli, ReportsReadAndWriteErrors) {
+  std::string args[] = { "convert", "--from", "euler", "--to", "quaternion" };
+  char* argv[] = { args[0].data(), args[1].data(), args[2].data(), args[3].data(), args[4].data() };
+  auto unreadable = std::fopen("/dev/null", "w"), unwritable = std::fopen("/dev/null", "r");
+  auto in = std::tmpfile(), out = std::tmpfile(), err = std::tmpfile();
+  std::fputs("0.1,0.2,0.3\n", in);
+  std::rewind(in);
+  EXPECT_EQ(1, convertMain(5, argv, unreadable, out, err));
+  EXPECT_EQ("", readAll(out));
+  EXPECT_EQ(0u, readAll(err).rfind("convert: ", 0));
+  err = std::tmpfile();
+  std::setvbuf(unwritable, nullptr, _IONBF, 0);
+  EXPECT_EQ(1, convertMain(5, argv, in, unwritable, err));
+  EXPECT_EQ(0u, readAll(err).rfind("convert: ", 0));
+  std::fclose(in);
+  std::fclose(unreadable);
+  std::fclose(unwritable);
+}
+
+TEST(ConvertCli, RejectsSameInputAndOutput) {
+  std::vector<Quaternion> quaternions(10, Quaternion(0, 0, 0, 1));
+  auto path = testing::TempDir() + "cli.rot";
+  writeRotationFile(path.c_str(), quaternions.data(), quaternions.size());
+  std::string output, error;
+  EXPECT_EQ(1, runConvert({ "--to", "matrix", "--input", path, "--output", path }, "", output, error));
+  EXPECT_EQ("convert: output of rotation file is the input.\n", error);
+  RotationFile file(path.c_str());
+  EXPECT_EQ(RotationKind::Quaternion, file.header().kind);
+  EXPECT_EQ(quaternions.size(), file.header().count);
+  std::remove(path.c_str());
+}